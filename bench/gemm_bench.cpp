@@ -0,0 +1,149 @@
+// ─────────────────────────────────────────────────────────────────────────────
+// gemm_bench — GFLOP/s of the packed GEMM engine vs the old naive i-j-k loop.
+//
+//   cmake -B build -DNEXA_BUILD_BENCH=ON && cmake --build build
+//   ./build/gemm_bench [max_size] [naive_max]
+//
+// max_size   largest square size to run        (default 4096)
+// naive_max  largest size the naive loop runs  (default 1024; it is very slow)
+// ─────────────────────────────────────────────────────────────────────────────
+#include "Gemm.h"
+#include "Small.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// The kernel nexa::matmul used before the GEMM engine — kept as the baseline.
+static void naiveMatmul(int m, int n, int p, const float* A, const float* B, float* C) {
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < p; j++) {
+            float s = 0;
+            for (int k = 0; k < n; k++) s += A[i * n + k] * B[k * p + j];
+            C[i * p + j] = s;
+        }
+}
+
+// Run fn until ~0.3 s has elapsed (at least once) and return the best time.
+template <typename Fn>
+static double bestSeconds(Fn fn) {
+    double best = 1e30, total = 0;
+    int runs = 0;
+    while (runs < 1 || (total < 0.3 && runs < 50)) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        best = std::min(best, s);
+        total += s;
+        ++runs;
+    }
+    return best;
+}
+
+static void runShape(int M, int N, int K, int naiveMax) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<float> A((size_t)M * K), B((size_t)K * N), C((size_t)M * N), R((size_t)M * N);
+    for (auto& v : A) v = dist(rng);
+    for (auto& v : B) v = dist(rng);
+
+    double flops = 2.0 * M * N * K;
+    double tFast = bestSeconds([&] { nexa::sgemm(M, N, K, A.data(), K, B.data(), N, C.data(), N); });
+
+    bool runNaive = std::max({M, N, K}) <= naiveMax;
+    double tNaive = 0, maxErr = 0;
+    if (runNaive) {
+        tNaive = bestSeconds([&] { naiveMatmul(M, K, N, A.data(), B.data(), R.data()); });
+        for (size_t i = 0; i < C.size(); ++i)
+            maxErr = std::max(maxErr, (double)std::fabs(C[i] - R[i]));
+    }
+
+    std::printf("%6d %6d %6d | %10.2f", M, N, K, flops / tFast * 1e-9);
+    if (runNaive)
+        std::printf(" | %10.2f | %7.1fx | %.2e\n", flops / tNaive * 1e-9, tNaive / tFast, maxErr);
+    else
+        std::printf(" | %10s | %8s | %s\n", "-", "-", "-");
+}
+
+// op(A) * op(B) with the transpose folded into packing, against explicitly
+// transposing the operand(s) with nexa::transpose and running the NN kernel.
+static void runTransposed(int n, nexa::Transpose ta, nexa::Transpose tb) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<float> A((size_t)n * n), B((size_t)n * n), C((size_t)n * n), R((size_t)n * n);
+    std::vector<float> At((size_t)n * n), Bt((size_t)n * n);
+    for (auto& v : A) v = dist(rng);
+    for (auto& v : B) v = dist(rng);
+    bool tA = ta == nexa::Transpose::Yes, tB = tb == nexa::Transpose::Yes;
+
+    double flops = 2.0 * n * n * n;
+    double tFold = bestSeconds([&] { nexa::sgemm(ta, tb, n, n, n, A.data(), n, B.data(), n, C.data(), n); });
+    double tCopy = bestSeconds([&] {
+        if (tA) nexa::transpose(n, n, A.data(), n, At.data(), n, sizeof(float));
+        if (tB) nexa::transpose(n, n, B.data(), n, Bt.data(), n, sizeof(float));
+        nexa::sgemm(n, n, n, tA ? At.data() : A.data(), n, tB ? Bt.data() : B.data(), n, R.data(), n);
+    });
+    double maxErr = 0;
+    for (size_t i = 0; i < C.size(); ++i) maxErr = std::max(maxErr, (double)std::fabs(C[i] - R[i]));
+    std::printf("  %c%c %6d | %10.2f | %10.2f | %.2e\n", tA ? 'T' : 'N', tB ? 'T' : 'N', n,
+                flops / tFold * 1e-9, flops / tCopy * 1e-9, maxErr);
+}
+
+// The unrolled fixed-size kernel (Small.h) against the packed engine, in
+// nanoseconds per product; both write into a preallocated C.
+static void runSmall(int n) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<float> A((size_t)n * n), B((size_t)n * n), C((size_t)n * n), R((size_t)n * n);
+    for (auto& v : A) v = dist(rng);
+    for (auto& v : B) v = dist(rng);
+
+    constexpr int REPS = 10000;
+    double tSmall = bestSeconds([&] {
+        for (int r = 0; r < REPS; ++r) nexa::smallMatmul(n, {A.data(), n, 1}, {B.data(), n, 1}, C.data());
+    }) / REPS;
+    double tGemm = bestSeconds([&] {
+        for (int r = 0; r < REPS; ++r) nexa::sgemm(n, n, n, A.data(), n, B.data(), n, R.data(), n);
+    }) / REPS;
+    double maxErr = 0;
+    for (size_t i = 0; i < C.size(); ++i) maxErr = std::max(maxErr, (double)std::fabs(C[i] - R[i]));
+    std::printf("  %d x %d    | %10.1f | %10.1f | %.2e\n", n, n, tSmall * 1e9, tGemm * 1e9, maxErr);
+}
+
+int main(int argc, char** argv) {
+    int maxSize  = argc > 1 ? std::atoi(argv[1]) : 4096;
+    int naiveMax = argc > 2 ? std::atoi(argv[2]) : 1024;
+
+    std::printf("micro-kernel: %s\n\n", nexa::sgemm_kernel_name());
+    std::printf("%6s %6s %6s | %10s | %10s | %8s | %s\n",
+                "M", "N", "K", "GFLOP/s", "naive", "speedup", "max |err|");
+    std::printf("---------------------+------------+------------+----------+----------\n");
+
+    for (int s = 64; s <= maxSize; s *= 2) runShape(s, s, s, naiveMax);
+
+    std::printf("\nskinny shapes\n");
+    for (int s = 256; s <= maxSize; s *= 4) {
+        runShape(s, 16, s, naiveMax);   // matrix x thin matrix
+        runShape(16, s, s, naiveMax);   // few rows, e.g. a small batch
+        runShape(s, s, 16, naiveMax);   // rank-16 outer product
+        runShape(s, 1, s, naiveMax);    // GEMV (lore_predict-style)
+    }
+
+    std::printf("\n%-11s | %10s | %10s | %s\n", "transposed", "folded", "copy + NN", "max |err|");
+    for (int s = 64; s <= std::min(maxSize, 2048); s *= 4)
+        for (auto t : {std::make_pair(nexa::Transpose::No,  nexa::Transpose::Yes),
+                       std::make_pair(nexa::Transpose::Yes, nexa::Transpose::No),
+                       std::make_pair(nexa::Transpose::Yes, nexa::Transpose::Yes)})
+            runTransposed(s, t.first, t.second);
+
+    std::printf("\n%-11s | %10s | %10s | %s\n", "small (ns)", "unrolled", "sgemm", "max |err|");
+    for (int n : {2, 3, 4, 8}) runSmall(n);
+    return 0;
+}
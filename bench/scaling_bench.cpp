@@ -0,0 +1,109 @@
+// ─────────────────────────────────────────────────────────────────────────────
+// scaling_bench — thread scaling of the parallel runtime kernels.
+//
+//   ./build/scaling_bench [max_threads]
+//
+// Runs matmul (1024², 2048²), ml_normalize, ml_standardize, lore_fit,
+// csv_read and csv_write (a generated ~100 MB file in the temp directory)
+// with 1, 2, 4, … threads (up to max_threads, default = all hardware
+// threads) and prints time, speedup over 1 thread and parallel efficiency.
+// ─────────────────────────────────────────────────────────────────────────────
+#include "Gemm.h"
+#include "Parallel.h"
+#include "Tensor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double bestSeconds(const std::function<void()>& fn, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - t0).count());
+    }
+    return best;
+}
+
+static void scale(const char* name, int maxThreads, int reps, const std::function<void()>& fn) {
+    std::printf("\n%s\n%8s | %10s | %8s | %s\n", name, "threads", "time (ms)", "speedup", "efficiency");
+    double base = 0;
+    for (int t = 1; t <= maxThreads; t *= 2) {
+        nexa_set_num_threads(t);
+        fn();                                   // warm-up: spawns the pool
+        double s = bestSeconds(fn, reps);
+        if (t == 1) base = s;
+        std::printf("%8d | %10.2f | %7.2fx | %5.0f%%\n", t, s * 1e3, base / s, 100.0 * base / s / t);
+        if (t < maxThreads && t * 2 > maxThreads) t = maxThreads / 2;   // always finish on maxThreads
+    }
+}
+
+static nexa::FloatBuffer randomData(size_t n) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(0.f, 4.f);
+    nexa::FloatBuffer v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+int main(int argc, char** argv) {
+    int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : hw;
+
+    for (int n : {1024, 2048}) {
+        auto A = randomData((size_t)n * n), B = randomData((size_t)n * n);
+        nexa::FloatBuffer C((size_t)n * n);
+        char title[64];
+        std::snprintf(title, sizeof title, "sgemm %d x %d x %d", n, n, n);
+        scale(title, maxThreads, 3, [&] {
+            nexa::sgemm(n, n, n, A.data(), n, B.data(), n, C.data(), n);
+        });
+    }
+
+    const int rows = 1 << 20, cols = 32;
+    nexa::Tensor X(randomData((size_t)rows * cols), {rows, cols});
+    scale("ml_normalize 1M x 32", maxThreads, 3, [&] {
+        ai_release(ml_normalize(&X));
+    });
+    scale("ml_standardize 1M x 32", maxThreads, 3, [&] {
+        ai_release(ml_standardize(&X));
+    });
+
+    const int fitRows = 200000, fitCols = 16;
+    nexa::Tensor Xf(randomData((size_t)fitRows * fitCols), {fitRows, fitCols});
+    nexa::FloatBuffer labels(fitRows);
+    for (int i = 0; i < fitRows; ++i) labels[i] = Xf.data()[(size_t)i * fitCols] > 2.f ? 1.f : 0.f;
+    nexa::Tensor y(std::move(labels), {fitRows, 1});
+    scale("lore_fit 200k x 16, 20 iterations", maxThreads, 2, [&] {
+        void* model = lore_create(20, 0.1f);
+        lore_fit(model, &Xf, &y);
+        ai_release(model);
+    });
+
+    const char* csvPath = "/tmp/nexa_scaling_bench.csv";
+    if (FILE* f = std::fopen(csvPath, "w")) {
+        auto v = randomData((size_t)1 << 23);
+        for (size_t i = 0; i < v.size(); i += 8)
+            std::fprintf(f, "%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%d\n",
+                         v[i], v[i + 1], v[i + 2], v[i + 3], v[i + 4], v[i + 5], v[i + 6], v[i + 7] > 2.f);
+        std::fclose(f);
+        scale("csv_read 1M x 8", maxThreads, 3, [&] {
+            ai_release(csv_read(csvPath, 0));
+        });
+        void* data = csv_read(csvPath, 0);
+        scale("csv_write 1M x 8", maxThreads, 3, [&] {
+            csv_write(csvPath, data);
+        });
+        ai_release(data);
+        std::remove(csvPath);
+    }
+    return 0;
+}
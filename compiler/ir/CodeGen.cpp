@@ -6,6 +6,7 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Constants.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/raw_ostream.h>
 
@@ -41,6 +42,30 @@ CodeGen::CodeGen()
         matrixType, llvm::Function::ExternalLinkage, "ai_create_matrix", module.get()
     );
 
+    // Tensor handle header — see CodeGen.h / runtime/ai/Tensor.h
+    {
+        auto* ptrTy = llvm::PointerType::get(context, 0);
+        auto* i64Ty = llvm::Type::getInt64Ty(context);
+        tensorHeaderTy = llvm::StructType::create(context,
+            { llvm::Type::getInt32Ty(context), ptrTy, ptrTy, i64Ty, i64Ty, i64Ty, i64Ty },
+            "nexa.tensor");
+
+        llvm::MDBuilder md(context);
+        auto* root     = md.createTBAARoot("nexa tbaa");
+        auto* headerTy = md.createTBAAScalarTypeNode("tensor header", root);
+        auto* floatTy  = md.createTBAAScalarTypeNode("tensor element", root);
+        tbaaHeader  = md.createTBAAStructTagNode(headerTy, headerTy, 0);
+        tbaaElement = md.createTBAAStructTagNode(floatTy, floatTy, 0);
+    }
+
+    // ai_from_data(const float* data, int rows, int cols) — copies a row-major buffer
+    module->getOrInsertFunction("ai_from_data",
+        llvm::FunctionType::get(
+            llvm::PointerType::get(context, 0),
+            { llvm::PointerType::get(context, 0),
+              llvm::Type::getInt32Ty(context), llvm::Type::getInt32Ty(context) },
+            false));
+
     // ai_set_value
     auto setValType = llvm::FunctionType::get(
         llvm::Type::getVoidTy(context),
@@ -76,6 +101,14 @@ CodeGen::CodeGen()
         printTensorType, llvm::Function::ExternalLinkage, "ai_print", module.get()
     );
 
+    // ai_retain / ai_release (void* handle) — same signature as ai_print
+    aiRetainFunc = llvm::Function::Create(
+        printTensorType, llvm::Function::ExternalLinkage, "ai_retain", module.get()
+    );
+    aiReleaseFunc = llvm::Function::Create(
+        printTensorType, llvm::Function::ExternalLinkage, "ai_release", module.get()
+    );
+
     // ai_zeros(int rows, int cols) -> Tensor*
     auto zerosType = llvm::FunctionType::get(
         llvm::PointerType::get(context, 0),
@@ -133,6 +166,10 @@ CodeGen::CodeGen()
     declareFileRuntime();
     declareCsvRuntime();
     declareMlRuntime();
+    declareParallelRuntime();
+    declareElementwiseRuntime();
+    declareReduceRuntime();
+    declareShapeRuntime();
 }
 
 // ── File runtime declarations ─────────────────────────────────────────────────
@@ -157,6 +194,10 @@ void CodeGen::declareFileRuntime() {
     // int nexa_file_exists(char* path)
     module->getOrInsertFunction("nexa_file_exists",
         llvm::FunctionType::get(i32Ty, {ptrTy}, false));
+
+    // void nexa_file_remove(char* path)
+    module->getOrInsertFunction("nexa_file_remove",
+        llvm::FunctionType::get(voidTy, {ptrTy}, false));
 }
 
 // ── CSV runtime declarations ──────────────────────────────────────────────────
@@ -171,10 +212,49 @@ void CodeGen::declareCsvRuntime() {
     module->getOrInsertFunction("csv_read",
         llvm::FunctionType::get(ptrTy, {ptrTy, i32Ty}, false));
 
+    // void* csv_read_cols(char* path, int skip_header, void* columns)
+    module->getOrInsertFunction("csv_read_cols",
+        llvm::FunctionType::get(ptrTy, {ptrTy, i32Ty, ptrTy}, false));
+
+    // void* csv_open(char* path, int skip_header), csv_open_cols(…, void* columns),
+    // void* csv_next_batch(void* cursor, int n), void csv_close(void* cursor)
+    module->getOrInsertFunction("csv_open",
+        llvm::FunctionType::get(ptrTy, {ptrTy, i32Ty}, false));
+    module->getOrInsertFunction("csv_open_cols",
+        llvm::FunctionType::get(ptrTy, {ptrTy, i32Ty, ptrTy}, false));
+    module->getOrInsertFunction("csv_next_batch",
+        llvm::FunctionType::get(ptrTy, {ptrTy, i32Ty}, false));
+    module->getOrInsertFunction("csv_close",
+        llvm::FunctionType::get(voidTy, {ptrTy}, false));
+
     // void csv_write(char* path, void* tensor)
     module->getOrInsertFunction("csv_write",
         llvm::FunctionType::get(voidTy, {ptrTy, ptrTy}, false));
 
+    // void csv_write_digits(char* path, void* tensor, int digits)
+    module->getOrInsertFunction("csv_write_digits",
+        llvm::FunctionType::get(voidTy, {ptrTy, ptrTy, i32Ty}, false));
+
+    // void* csv_read_table(char* path, int text_mode), void* table_data(void* table),
+    // int table_index(void* table, char* name), void* table_col(void* table, char* name),
+    // char* table_label(void* table, char* name, int code)
+    module->getOrInsertFunction("csv_read_table",
+        llvm::FunctionType::get(ptrTy, {ptrTy, i32Ty}, false));
+    module->getOrInsertFunction("table_data",
+        llvm::FunctionType::get(ptrTy, {ptrTy}, false));
+    module->getOrInsertFunction("table_index",
+        llvm::FunctionType::get(i32Ty, {ptrTy, ptrTy}, false));
+    module->getOrInsertFunction("table_col",
+        llvm::FunctionType::get(ptrTy, {ptrTy, ptrTy}, false));
+    module->getOrInsertFunction("table_label",
+        llvm::FunctionType::get(ptrTy, {ptrTy, ptrTy, i32Ty}, false));
+
+    // void save_tensor(char* path, void* tensor), void* load_tensor(char* path)
+    module->getOrInsertFunction("save_tensor",
+        llvm::FunctionType::get(voidTy, {ptrTy, ptrTy}, false));
+    module->getOrInsertFunction("load_tensor",
+        llvm::FunctionType::get(ptrTy, {ptrTy}, false));
+
     // int csv_rows(void* tensor)
     module->getOrInsertFunction("csv_rows",
         llvm::FunctionType::get(i32Ty, {ptrTy}, false));
@@ -212,14 +292,48 @@ void CodeGen::declareMlRuntime() {
     auto* i32Ty  = llvm::Type::getInt32Ty(context);
     auto* f32Ty  = llvm::Type::getFloatTy(context);
 
-    // void* ml_normalize(void* X)
-    module->getOrInsertFunction("ml_normalize",
-        llvm::FunctionType::get(ptrTy, {ptrTy}, false));
+    // void* ml_normalize / ml_standardize / ml_robust_scale(void* X)
+    for (const char* name : {"ml_normalize", "ml_standardize", "ml_robust_scale"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy}, false));
 
     // void* ml_shuffle(void* X)
     module->getOrInsertFunction("ml_shuffle",
         llvm::FunctionType::get(ptrTy, {ptrTy}, false));
 
+    // void* ml_clip(void* X, float lo, float hi)
+    module->getOrInsertFunction("ml_clip",
+        llvm::FunctionType::get(ptrTy, {ptrTy, f32Ty, f32Ty}, false));
+
+    // In place: void ml_normalize_ / ml_standardize_ / ml_robust_scale_ / ml_shuffle_(void* X),
+    // ml_scale_(void* X, float s), ml_clip_(void* X, float lo, float hi)
+    for (const char* name : {"ml_normalize_", "ml_standardize_", "ml_robust_scale_", "ml_shuffle_"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(voidTy, {ptrTy}, false));
+    module->getOrInsertFunction("ml_scale_",
+        llvm::FunctionType::get(voidTy, {ptrTy, f32Ty}, false));
+    module->getOrInsertFunction("ml_clip_",
+        llvm::FunctionType::get(voidTy, {ptrTy, f32Ty, f32Ty}, false));
+
+    // x = normalize(x) / shuffle(x) / clip(x, lo, hi) / …: reuse x's buffer when possible
+    for (const char* name : {"ml_normalize_reuse", "ml_standardize_reuse", "ml_robust_scale_reuse",
+                             "ml_shuffle_reuse"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy}, false));
+    module->getOrInsertFunction("ml_clip_reuse",
+        llvm::FunctionType::get(ptrTy, {ptrTy, f32Ty, f32Ty}, false));
+
+    // void* ml_minmax_scaler / ml_standard_scaler / ml_robust_scaler(void* X)
+    for (const char* name : {"ml_minmax_scaler", "ml_standard_scaler", "ml_robust_scaler"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy}, false));
+
+    // void* ml_transform(void* scaler, void* X), void ml_transform_(void* scaler, void* X)
+    module->getOrInsertFunction("ml_transform",
+        llvm::FunctionType::get(ptrTy, {ptrTy, ptrTy}, false));
+    module->getOrInsertFunction("ml_transform_",
+        llvm::FunctionType::get(voidTy, {ptrTy, ptrTy}, false));
+
     // void* ml_train_split(void* X, float ratio)
     module->getOrInsertFunction("ml_train_split",
         llvm::FunctionType::get(ptrTy, {ptrTy, f32Ty}, false));
@@ -265,6 +379,140 @@ void CodeGen::declareMlRuntime() {
         llvm::FunctionType::get(f32Ty, {ptrTy}, false));
 }
 
+// ── Thread pool / allocator declarations ──────────────────────────────────────
+
+void CodeGen::declareParallelRuntime() {
+    auto* voidTy = llvm::Type::getVoidTy(context);
+    auto* i32Ty  = llvm::Type::getInt32Ty(context);
+
+    // void nexa_set_num_threads(int n)   (n < 1 → NEXA_NUM_THREADS / all cores)
+    module->getOrInsertFunction("nexa_set_num_threads",
+        llvm::FunctionType::get(voidTy, {i32Ty}, false));
+
+    // int nexa_get_num_threads()
+    module->getOrInsertFunction("nexa_get_num_threads",
+        llvm::FunctionType::get(i32Ty, {}, false));
+
+    // void nexa_alloc_stats()   — tensor allocator counters to stderr
+    module->getOrInsertFunction("nexa_alloc_stats",
+        llvm::FunctionType::get(voidTy, {}, false));
+
+    // void nexa_alloc_trim()    — return cached tensor buffers to the OS
+    module->getOrInsertFunction("nexa_alloc_trim",
+        llvm::FunctionType::get(voidTy, {}, false));
+
+    // void nexa_set_lazy(int on), void nexa_lazy_flush()
+    module->getOrInsertFunction("nexa_set_lazy",
+        llvm::FunctionType::get(voidTy, {i32Ty}, false));
+    module->getOrInsertFunction("nexa_lazy_flush",
+        llvm::FunctionType::get(voidTy, {}, false));
+
+    // extern int nexa_lazy_pending   — number of unevaluated lazy tensors
+    module->getOrInsertGlobal("nexa_lazy_pending", i32Ty);
+}
+
+// ── Element-wise tensor op declarations ───────────────────────────────────────
+
+void CodeGen::declareElementwiseRuntime() {
+    auto* ptrTy  = llvm::PointerType::get(context, 0);
+    auto* f32Ty  = llvm::Type::getFloatTy(context);
+
+    // void* ai_add / ai_sub / ai_mul / ai_div (void* a, void* b)  — broadcasting
+    for (const char* name : {"ai_add", "ai_sub", "ai_mul", "ai_div"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy, ptrTy}, false));
+
+    // void* ai_<op>_scalar(void* t, float s)  — t op s  (ai_r*: s op t)
+    for (const char* name : {"ai_add_scalar", "ai_sub_scalar", "ai_mul_scalar",
+                             "ai_div_scalar", "ai_rsub_scalar", "ai_rdiv_scalar"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy, f32Ty}, false));
+
+    // Shape-specialised entry points, used when sema knows both static shapes:
+    // void* ai_<op>_same(void* a, void* b)  — identical shapes, no broadcasting
+    for (const char* name : {"ai_add_same", "ai_sub_same", "ai_mul_same", "ai_div_same"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy, ptrTy}, false));
+
+    // void* ai_matmul_2d(void* a, void* b)  — [m x n] * [n x p], no shape checks
+    // void* ai_matmul_<n>(void* a, void* b)  — [n x n] * [n x n], unrolled kernel
+    for (const char* name : {"ai_matmul_2d", "ai_matmul_2", "ai_matmul_3", "ai_matmul_4", "ai_matmul_8"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy, ptrTy}, false));
+}
+
+// Runtime entry point for a tensor ⊕ tensor op, specialised when both static
+// shapes are known (sema has already checked them): identical shapes skip
+// broadcasting, 2-D matmuls skip the batch / shape logic, and square
+// 2x2 / 3x3 / 4x4 / 8x8 products go straight to their unrolled kernel.
+std::string CodeGen::tensorOpEntry(const std::string& opName, Type* l, Type* r) {
+    bool known = l && r && l->hasShape() && r->hasShape();
+    if (opName == "matmul") {
+        if (!known || l->dims.size() != 2 || r->dims.size() != 2) return "ai_matmul";
+        int n = l->dims[0];
+        bool square = l->dims[1] == n && r->dims[0] == n && r->dims[1] == n;
+        if (square && (n == 2 || n == 3 || n == 4 || n == 8)) return "ai_matmul_" + std::to_string(n);
+        return "ai_matmul_2d";
+    }
+    return "ai_" + opName + (known && l->dims == r->dims ? "_same" : "");
+}
+
+// ── Reduction declarations ────────────────────────────────────────────────────
+
+void CodeGen::declareShapeRuntime() {
+    auto* ptrTy  = llvm::PointerType::get(context, 0);
+    auto* i32Ty  = llvm::Type::getInt32Ty(context);
+
+    // void* ai_ones(int rows, int cols)
+    module->getOrInsertFunction("ai_ones",
+        llvm::FunctionType::get(ptrTy, {i32Ty, i32Ty}, false));
+
+    // void* ai_zeros_nd / ai_ones_nd(const int* dims, int ndim)
+    for (const char* name : {"ai_zeros_nd", "ai_ones_nd"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy, i32Ty}, false));
+
+    // void* ai_reshape_nd(void* t, const int* dims, int ndim)
+    module->getOrInsertFunction("ai_reshape_nd",
+        llvm::FunctionType::get(ptrTy, {ptrTy, ptrTy, i32Ty}, false));
+
+    // void* ai_to_f32 / ai_to_bf16 / ai_to_f16 / ai_quantize(void* t)
+    for (const char* name : {"ai_to_f32", "ai_to_bf16", "ai_to_f16", "ai_quantize"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy}, false));
+
+    // void* ai_transpose(void* t)
+    module->getOrInsertFunction("ai_transpose",
+        llvm::FunctionType::get(ptrTy, {ptrTy}, false));
+
+    // float ai_det(void* t), void* ai_inverse(void* t)
+    module->getOrInsertFunction("ai_det",
+        llvm::FunctionType::get(llvm::Type::getFloatTy(context), {ptrTy}, false));
+    module->getOrInsertFunction("ai_inverse",
+        llvm::FunctionType::get(ptrTy, {ptrTy}, false));
+
+    // const char* ai_dtype(void* t)
+    module->getOrInsertFunction("ai_dtype",
+        llvm::FunctionType::get(ptrTy, {ptrTy}, false));
+
+    // int ai_ndim(void* t), int ai_dim(void* t, int axis)
+    module->getOrInsertFunction("ai_ndim",
+        llvm::FunctionType::get(i32Ty, {ptrTy}, false));
+    module->getOrInsertFunction("ai_dim",
+        llvm::FunctionType::get(i32Ty, {ptrTy, i32Ty}, false));
+}
+
+void CodeGen::declareReduceRuntime() {
+    auto* ptrTy  = llvm::PointerType::get(context, 0);
+    auto* i32Ty  = llvm::Type::getInt32Ty(context);
+
+    // void* ai_<op>_axis(void* t, int axis)  — 0 → [1 x cols], 1 → [rows x 1]
+    for (const char* name : {"ai_sum_axis", "ai_mean_axis", "ai_max_axis",
+                             "ai_min_axis", "ai_argmax"})
+        module->getOrInsertFunction(name,
+            llvm::FunctionType::get(ptrTy, {ptrTy, i32Ty}, false));
+}
+
 llvm::Module* CodeGen::getModule() {
     return module.get();
 }
@@ -291,6 +539,111 @@ llvm::Type* CodeGen::getLLVMType(Type* type)
     return llvm::Type::getVoidTy(context);
 }
 
+// =============================
+// Scopes & Reference Counting
+// =============================
+//
+// Ownership rules for tensor handles in generated code:
+//   • calls, tensor literals and tensor operators yield an owned (+1) value
+//   • variable / field reads are borrowed
+//   • a variable owns one reference: borrowed initialisers are retained,
+//     the previous value is released on reassignment, and every tensor
+//     variable is released when its scope closes (or on return)
+//   • a struct variable owns its instance: a literal or constructor result
+//     is taken over, any other struct is copied with its tensor fields
+//     retained; assignment copies into the instance, and the tensor fields
+//     are released when the scope closes
+//   • owned values passed to a call / operator / print are released right
+//     after use; callees never take ownership of their arguments
+//   • functions return an owned value
+
+// Allocas go in the entry block so variables declared inside a loop body
+// reuse one stack slot instead of growing the stack every iteration.
+llvm::AllocaInst* CodeGen::createEntryAlloca(llvm::Type* type, const std::string& name) {
+    auto* fn = builder.GetInsertBlock()->getParent();
+    llvm::IRBuilder<> entry(&fn->getEntryBlock(), fn->getEntryBlock().begin());
+    return entry.CreateAlloca(type, nullptr, name);
+}
+
+void CodeGen::pushScope() {
+    scopes.emplace_back();
+}
+
+void CodeGen::popScope() {
+    if (scopes.empty()) return;
+    if (!builder.GetInsertBlock()->getTerminator())
+        releaseScopes(scopes.size() - 1);
+
+    auto& shadowed = scopes.back().shadowed;
+    for (auto it = shadowed.rbegin(); it != shadowed.rend(); ++it) {
+        if (it->second) namedValues[it->first] = it->second;
+        else            namedValues.erase(it->first);
+    }
+    scopes.pop_back();
+}
+
+void CodeGen::releaseScopes(size_t from) {
+    auto* ptrTy = llvm::PointerType::get(context, 0);
+    for (size_t i = scopes.size(); i-- > from; ) {
+        auto& slots = scopes[i].tensorSlots;
+        for (auto it = slots.rbegin(); it != slots.rend(); ++it)
+            builder.CreateCall(aiReleaseFunc, { builder.CreateLoad(ptrTy, *it) });
+        auto& structs = scopes[i].structSlots;
+        for (auto it = structs.rbegin(); it != structs.rend(); ++it)
+            structFieldRefs(aiReleaseFunc, it->second, builder.CreateLoad(ptrTy, it->first));
+    }
+}
+
+void CodeGen::declareVariable(const std::string& name, llvm::AllocaInst* slot, bool isTensor) {
+    if (!scopes.empty()) {
+        auto it = namedValues.find(name);
+        scopes.back().shadowed.push_back({name, it == namedValues.end() ? nullptr : it->second});
+        if (isTensor) scopes.back().tensorSlots.push_back(slot);
+    }
+    namedValues[name] = slot;
+}
+
+// A struct variable: the slot holds a pointer to an instance it owns
+void CodeGen::declareStruct(const std::string& name, llvm::AllocaInst* slot, const std::string& structName) {
+    declareVariable(name, slot, false);
+    if (!scopes.empty()) scopes.back().structSlots.push_back({slot, structName});
+}
+
+bool CodeGen::ownsStruct(Expr* expr) {
+    if (auto group = dynamic_cast<GroupingExpr*>(expr))
+        return ownsStruct(group->expression.get());
+    return dynamic_cast<StructLiteralExpr*>(expr) || dynamic_cast<ConstructorCallExpr*>(expr);
+}
+
+// fn (ai_retain / ai_release) on every tensor field of instance
+void CodeGen::structFieldRefs(llvm::Function* fn, const std::string& structName, llvm::Value* instance) {
+    auto* st    = structTypes[structName];
+    auto* ptrTy = llvm::PointerType::get(context, 0);
+    for (int idx : structTensorFields[structName])
+        builder.CreateCall(fn, { builder.CreateLoad(ptrTy, builder.CreateStructGEP(st, instance, idx)) });
+}
+
+bool CodeGen::ownsTensor(Expr* expr) {
+    if (!expr || !expr->inferredType || !expr->inferredType->isTensor()) return false;
+    if (auto group = dynamic_cast<GroupingExpr*>(expr))
+        return ownsTensor(group->expression.get());
+    return dynamic_cast<CallExpr*>(expr)          ||
+           dynamic_cast<TensorLiteralExpr*>(expr) ||
+           dynamic_cast<BinaryExpr*>(expr);
+}
+
+llvm::Value* CodeGen::retainIfBorrowed(Expr* expr, llvm::Value* val) {
+    if (val && val->getType()->isPointerTy() &&
+        expr && expr->inferredType && expr->inferredType->isTensor() && !ownsTensor(expr))
+        builder.CreateCall(aiRetainFunc, {val});
+    return val;
+}
+
+void CodeGen::releaseIfOwned(Expr* expr, llvm::Value* val) {
+    if (val && val->getType()->isPointerTy() && ownsTensor(expr))
+        builder.CreateCall(aiReleaseFunc, {val});
+}
+
 // =============================
 // Program Generation
 // =============================
@@ -311,10 +664,13 @@ void CodeGen::generate(Program& program)
     auto entry = llvm::BasicBlock::Create(context, "entry", mainFunc);
     builder.SetInsertPoint(entry);
 
+    scopes.clear();
+    pushScope();
     for (auto& stmt : program.statements)
         if (!dynamic_cast<FunctionDecl*>(stmt.get()) &&
             !dynamic_cast<StructDecl*>(stmt.get()))
             generateStmt(stmt.get());
+    popScope();
 
     if (!builder.GetInsertBlock()->getTerminator())
         builder.CreateRet(llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 0));
@@ -352,14 +708,17 @@ void CodeGen::generateStmt(Stmt* stmt)
     if (auto sd = dynamic_cast<StructDecl*>(stmt)) {
         std::vector<llvm::Type*> fieldTypes;
         std::vector<std::pair<std::string, int>> fieldMap;
+        std::vector<int> tensorFields;
         int idx = 0;
         for (auto& [name, type] : sd->fields) {
             fieldTypes.push_back(getLLVMType(type));
+            if (type && type->isTensor()) tensorFields.push_back(idx);
             fieldMap.push_back({name, idx++});
         }
         auto* st = llvm::StructType::create(context, fieldTypes, sd->name);
-        structTypes[sd->name]  = st;
-        structFields[sd->name] = fieldMap;
+        structTypes[sd->name]        = st;
+        structFields[sd->name]       = fieldMap;
+        structTensorFields[sd->name] = tensorFields;
 
         // Generate constructor if present
         if (sd->constructor) {
@@ -378,28 +737,36 @@ void CodeGen::generateStmt(Stmt* stmt)
             builder.SetInsertPoint(block);
 
             auto oldValues = namedValues;
+            auto oldScopes = std::move(scopes);
             namedValues.clear();
+            scopes.clear();
+            pushScope();
 
             // 'self' is the first argument
             auto argIt = ctorFunc->arg_begin();
             llvm::Value* selfPtr = &*argIt++;
             namedValues["self"] = selfPtr;
 
+            // Tensor parameters are retained so the body may reassign them
             int pi = 0;
             for (; argIt != ctorFunc->arg_end(); ++argIt, ++pi) {
                 auto& [pname, ptype] = sd->constructor->params[pi];
                 auto* alloca = builder.CreateAlloca(argIt->getType(), nullptr, pname);
                 builder.CreateStore(&*argIt, alloca);
-                namedValues[pname] = alloca;
+                bool isTensor = ptype && ptype->isTensor();
+                if (isTensor) builder.CreateCall(aiRetainFunc, {&*argIt});
+                declareVariable(pname, alloca, isTensor);
             }
 
             for (auto& s : sd->constructor->body)
                 generateStmt(s.get());
 
+            popScope();
             if (!builder.GetInsertBlock()->getTerminator())
                 builder.CreateRetVoid();
 
             namedValues = oldValues;
+            scopes      = std::move(oldScopes);
             if (oldBlock) builder.SetInsertPoint(oldBlock);
         }
         return;
@@ -421,29 +788,40 @@ void CodeGen::generateStmt(Stmt* stmt)
         builder.SetInsertPoint(block);
 
         auto oldValues = namedValues;
+        auto oldScopes = std::move(scopes);
         namedValues.clear();
+        scopes.clear();
+        pushScope();
 
+        // Tensor parameters are retained so the body may reassign them
         int idx = 0;
         for (auto& arg : function->args()) {
-            auto paramName = fn->params[idx++].first;
+            auto& [paramName, paramType] = fn->params[idx++];
             auto alloca    = builder.CreateAlloca(arg.getType(), nullptr, paramName);
             builder.CreateStore(&arg, alloca);
-            namedValues[paramName] = alloca;
+            bool isTensor = paramType && paramType->isTensor();
+            if (isTensor) builder.CreateCall(aiRetainFunc, {&arg});
+            declareVariable(paramName, alloca, isTensor);
         }
 
         for (auto& s : fn->body)
             generateStmt(s.get());
 
+        popScope();
         if (!builder.GetInsertBlock()->getTerminator()) {
             if (fn->returnType && fn->returnType->isDouble())
                 builder.CreateRet(llvm::ConstantFP::get(context, llvm::APFloat(0.0)));
             else if (fn->returnType && fn->returnType->isInt())
                 builder.CreateRet(llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 0));
+            else if (function->getReturnType()->isPointerTy())
+                builder.CreateRet(llvm::ConstantPointerNull::get(
+                    llvm::cast<llvm::PointerType>(function->getReturnType())));
             else
                 builder.CreateRetVoid();
         }
 
         namedValues = oldValues;
+        scopes      = std::move(oldScopes);
         if (oldBlock) builder.SetInsertPoint(oldBlock);
         return;
     }
@@ -451,6 +829,8 @@ void CodeGen::generateStmt(Stmt* stmt)
     // ── Return ────────────────────────────────
     if (auto ret = dynamic_cast<ReturnStmt*>(stmt)) {
         auto val = generateExpr(ret->value.get());
+        val = retainIfBorrowed(ret->value.get(), val);   // the caller gets its own reference
+        releaseScopes(0);
         if (val) builder.CreateRet(val);
         else     builder.CreateRetVoid();
         return;
@@ -463,15 +843,44 @@ void CodeGen::generateStmt(Stmt* stmt)
             std::cerr << "[CodeGen] ERROR: initializer for '" << var->name << "' produced null\n";
             return;
         }
-        auto alloca = builder.CreateAlloca(getLLVMType(var->declaredType), nullptr, var->name);
+        bool isTensor = var->declaredType && var->declaredType->isTensor();
+        if (isTensor) initVal = retainIfBorrowed(var->initializer.get(), initVal);
+
+        auto alloca = createEntryAlloca(getLLVMType(var->declaredType), var->name);
+        if (var->declaredType && var->declaredType->isStruct() && structTypes.count(var->declaredType->structName)) {
+            // A fresh instance is taken over; anything else is copied, its tensors retained
+            const std::string& name = var->declaredType->structName;
+            if (!ownsStruct(var->initializer.get())) {
+                auto* st   = structTypes[name];
+                auto* copy = createEntryAlloca(st, var->name + "_inst");
+                builder.CreateStore(builder.CreateLoad(st, initVal), copy);
+                structFieldRefs(aiRetainFunc, name, copy);
+                initVal = copy;
+            }
+            builder.CreateStore(initVal, alloca);
+            declareStruct(var->name, alloca, name);
+            return;
+        }
         builder.CreateStore(initVal, alloca);
-        namedValues[var->name] = alloca;
+        declareVariable(var->name, alloca, isTensor);
         return;
     }
 
     // ── Assignment ────────────────────────────
     if (auto assign = dynamic_cast<AssignmentStmt*>(stmt)) {
+        // x = normalize(x) / shuffle(x) / clip(x, ...) / ...: x's old value is dead
+        // after the store, so the runtime may transform it in place
+        auto* target = dynamic_cast<VariableExpr*>(assign->target.get());
+        if (auto* call = dynamic_cast<CallExpr*>(assign->value.get())) {
+            auto* arg = call->arguments.empty() ? nullptr
+                                                : dynamic_cast<VariableExpr*>(call->arguments[0].get());
+            if (target && arg && arg->name == target->name &&
+                (call->callee == "normalize" || call->callee == "standardize" ||
+                 call->callee == "robust_scale" || call->callee == "shuffle" || call->callee == "clip"))
+                reuseCall = call;
+        }
         auto value = generateExpr(assign->value.get());
+        reuseCall = nullptr;
         if (!value) { std::cerr << "[CodeGen] ERROR: assignment RHS is null\n"; return; }
 
         if (auto var = dynamic_cast<VariableExpr*>(assign->target.get())) {
@@ -481,6 +890,30 @@ void CodeGen::generateStmt(Stmt* stmt)
                           << var->name << "'\n";
                 return;
             }
+            const std::string* owned = nullptr;
+            for (auto& sc : scopes)
+                for (auto& [slot, name] : sc.structSlots)
+                    if (slot == it->second) owned = &name;
+            if (owned) {
+                // Copied into the variable's own instance: the new tensors are
+                // retained (or taken over from a fresh one) before the old go
+                auto* st  = structTypes[*owned];
+                auto* dst = builder.CreateLoad(llvm::PointerType::get(context, 0), it->second);
+                if (!ownsStruct(assign->value.get())) structFieldRefs(aiRetainFunc, *owned, value);
+                auto* old = builder.CreateLoad(st, dst);
+                builder.CreateStore(builder.CreateLoad(st, value), dst);
+                for (int idx : structTensorFields[*owned])
+                    builder.CreateCall(aiReleaseFunc, {builder.CreateExtractValue(old, idx)});
+                return;
+            }
+            if (assign->value->inferredType && assign->value->inferredType->isTensor()) {
+                // Retain the new value before dropping the old one: `x = x` is safe
+                value = retainIfBorrowed(assign->value.get(), value);
+                auto* old = builder.CreateLoad(llvm::PointerType::get(context, 0), it->second);
+                builder.CreateStore(value, it->second);
+                builder.CreateCall(aiReleaseFunc, {old});
+                return;
+            }
             builder.CreateStore(value, it->second);
         }
         return;
@@ -518,7 +951,15 @@ void CodeGen::generateStmt(Stmt* stmt)
 
         auto val = generateExpr(sa->value.get());
         if (!val) return;
+        val = retainIfBorrowed(sa->value.get(), val);
         auto ptr = builder.CreateStructGEP(st, selfPtr, idx, sa->field + "_ptr");
+        if (sa->value->inferredType && sa->value->inferredType->isTensor()) {
+            // As for variables: drop the field's old tensor after the store
+            auto* old = builder.CreateLoad(llvm::PointerType::get(context, 0), ptr);
+            builder.CreateStore(val, ptr);
+            builder.CreateCall(aiReleaseFunc, {old});
+            return;
+        }
         builder.CreateStore(val, ptr);
         return;
     }
@@ -535,8 +976,12 @@ void CodeGen::generateStmt(Stmt* stmt)
         bool needZExt   = false;
 
         if (type) {
-            if      (type->isTensor()) { builder.CreateCall(aiPrintTensorFunc, {val}); return; }
-            else if (type->isDouble()) fmt = "%.6g\n";
+            if (type->isTensor()) {
+                builder.CreateCall(aiPrintTensorFunc, {val});
+                releaseIfOwned(print->expression.get(), val);
+                return;
+            }
+            if      (type->isDouble()) fmt = "%.6g\n";
             else if (type->isString()) fmt = "%s\n";
             else if (type->isBool())   { fmt = "%d\n"; needZExt = true; }
             else                       fmt = "%d\n";
@@ -569,7 +1014,7 @@ void CodeGen::generateStmt(Stmt* stmt)
             if (prevIt != namedValues.end()) prevIterVal = prevIt->second;
         }
 
-        auto loopVar = builder.CreateAlloca(llvm::Type::getInt32Ty(context), nullptr, loop->iterator);
+        auto loopVar = createEntryAlloca(llvm::Type::getInt32Ty(context), loop->iterator);
         builder.CreateStore(llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 0), loopVar);
         namedValues[loop->iterator] = loopVar;
 
@@ -585,7 +1030,9 @@ void CodeGen::generateStmt(Stmt* stmt)
         builder.CreateCondBr(cond, bodyBlock, endBlock);
 
         builder.SetInsertPoint(bodyBlock);
+        pushScope();
         for (auto& s : loop->body) generateStmt(s.get());
+        popScope();   // per-iteration tensors die here
 
         if (!builder.GetInsertBlock()->getTerminator()) {
             auto next = builder.CreateAdd(
@@ -620,11 +1067,15 @@ void CodeGen::generateStmt(Stmt* stmt)
         builder.CreateCondBr(condVal, thenBlock, elseBlock);
 
         builder.SetInsertPoint(thenBlock);
+        pushScope();
         for (auto& s : ifStmt->thenBranch) generateStmt(s.get());
+        popScope();
         if (!builder.GetInsertBlock()->getTerminator()) builder.CreateBr(mergeBlock);
 
         builder.SetInsertPoint(elseBlock);
+        pushScope();
         for (auto& s : ifStmt->elseBranch) generateStmt(s.get());
+        popScope();
         if (!builder.GetInsertBlock()->getTerminator()) builder.CreateBr(mergeBlock);
 
         builder.SetInsertPoint(mergeBlock);
@@ -685,6 +1136,234 @@ llvm::Value* CodeGen::generateFileExpr(FileExpr* fe) {
     return nullptr;
 }
 
+// =============================
+// Tensor Arithmetic
+// =============================
+
+// int / double / float scalar → float (runtime tensors are f32)
+llvm::Value* CodeGen::toFloat(llvm::Value* v) {
+    auto* f32Ty = llvm::Type::getFloatTy(context);
+    if (v->getType()->isIntegerTy(1)) return builder.CreateUIToFP(v, f32Ty, "b2f");
+    if (v->getType()->isIntegerTy())  return builder.CreateSIToFP(v, f32Ty, "i2f");
+    if (v->getType()->isDoubleTy())   return builder.CreateFPTrunc(v, f32Ty, "d2f");
+    return v;
+}
+
+llvm::Value* CodeGen::toIndex(llvm::Value* v) {
+    auto* i64Ty = llvm::Type::getInt64Ty(context);
+    if (v->getType()->isIntegerTy(1))  return builder.CreateZExt(v, i64Ty, "idx");
+    if (v->getType()->isIntegerTy())   return builder.CreateSExtOrTrunc(v, i64Ty, "idx");
+    if (v->getType()->isFloatingPointTy()) return builder.CreateFPToSI(v, i64Ty, "idx");
+    return v;
+}
+
+// ── Inline tensor access ──────────────────────────────────────────────────────
+
+llvm::Value* CodeGen::loadTensorField(llvm::Value* tensor, TensorField field, const std::string& name) {
+    auto* ptr  = builder.CreateStructGEP(tensorHeaderTy, tensor, field, name + "_ptr");
+    auto* type = tensorHeaderTy->getElementType(field);
+    auto* load = builder.CreateAlignedLoad(type, ptr, llvm::Align(8), name);
+    load->setMetadata(llvm::LLVMContext::MD_tbaa, tbaaHeader);
+    return load;
+}
+
+// &elems[row * rowStride + col * colStride]
+llvm::Value* CodeGen::tensorElementPtr(llvm::Value* tensor, llvm::Value* elems, llvm::Value* row, llvm::Value* col) {
+    auto* rs    = loadTensorField(tensor, TF_RowStride, "row_stride");
+    auto* cs    = loadTensorField(tensor, TF_ColStride, "col_stride");
+    auto* index = builder.CreateAdd(builder.CreateNSWMul(toIndex(row), rs),
+                                    builder.CreateNSWMul(toIndex(col), cs), "elem_idx", false, true);
+    return builder.CreateInBoundsGEP(llvm::Type::getFloatTy(context), elems, index, "elem_ptr");
+}
+
+// get_value / csv_get (t, r, c), set_value / csv_set (t, r, c, v) and
+// csv_rows / csv_cols (t) read the tensor header directly instead of calling
+// into the runtime, so loops over tensor elements stay visible to LLVM.
+// Element access checks elems first: it is null for bf16 / f16 / i8 tensors,
+// which take the runtime call instead. The check is loop-invariant, so LLVM
+// can hoist it out of element loops.
+// Stores also check nexa_lazy_pending and evaluate any pending lazy tensors
+// first (runtime/ai/Lazy.h); outside lazy mode it is always 0.
+bool CodeGen::generateTensorAccess(CallExpr* call, llvm::Value*& result) {
+    const std::string& fn = call->callee;
+    size_t argc = call->arguments.size();
+    bool get  = (fn == "get_value" || fn == "csv_get")  && argc == 3;
+    bool set  = (fn == "set_value" || fn == "csv_set")  && argc == 4;
+    bool dims = (fn == "csv_rows"  || fn == "csv_cols") && argc == 1;
+    if (!get && !set && !dims) return false;
+
+    result = nullptr;
+    Expr* tensorArg = call->arguments[0].get();
+    auto* tensor = generateExpr(tensorArg);
+    if (!tensor || !tensor->getType()->isPointerTy()) {
+        std::cerr << "[CodeGen] ERROR: " << fn << " expects a tensor as its first argument\n";
+        return true;
+    }
+
+    if (dims) {
+        auto* n = loadTensorField(tensor, fn == "csv_rows" ? TF_Rows : TF_Cols, fn == "csv_rows" ? "rows" : "cols");
+        result = builder.CreateTrunc(n, llvm::Type::getInt32Ty(context), fn);
+    } else {
+        auto* row = generateExpr(call->arguments[1].get());
+        auto* col = generateExpr(call->arguments[2].get());
+        if (!row || !col) return true;
+        llvm::Value* val = nullptr;
+        if (set) {
+            val = generateExpr(call->arguments[3].get());
+            if (!val) return true;
+            val = toFloat(val);
+        }
+
+        auto* i32Ty  = llvm::Type::getInt32Ty(context);
+        auto* func   = builder.GetInsertBlock()->getParent();
+        if (set) {
+            // lazy mode: pending results must not see this write — evaluate them first
+            auto* pending = builder.CreateAlignedLoad(i32Ty, module->getGlobalVariable("nexa_lazy_pending"),
+                                                      llvm::Align(4), "lazy_pending");
+            pending->setMetadata(llvm::LLVMContext::MD_tbaa, tbaaHeader);
+            auto* flushBB = llvm::BasicBlock::Create(context, "lazy_flush", func);
+            auto* storeBB = llvm::BasicBlock::Create(context, "elem_store", func);
+            builder.CreateCondBr(builder.CreateICmpNE(pending, builder.getInt32(0)), flushBB, storeBB);
+            builder.SetInsertPoint(flushBB);
+            builder.CreateCall(module->getFunction("nexa_lazy_flush"));
+            builder.CreateBr(storeBB);
+            builder.SetInsertPoint(storeBB);
+        }
+        auto* elems  = loadTensorField(tensor, TF_Elems, "elems");
+        auto* fastBB = llvm::BasicBlock::Create(context, "elem_f32", func);
+        auto* slowBB = llvm::BasicBlock::Create(context, "elem_call", func);
+        auto* doneBB = llvm::BasicBlock::Create(context, "elem_done", func);
+        builder.CreateCondBr(builder.CreateIsNotNull(elems, "is_f32"), fastBB, slowBB);
+
+        builder.SetInsertPoint(fastBB);
+        auto* ptr = tensorElementPtr(tensor, elems, row, col);
+        llvm::Value* fast = nullptr;
+        if (get) {
+            auto* load = builder.CreateAlignedLoad(llvm::Type::getFloatTy(context), ptr, llvm::Align(4), "elem");
+            load->setMetadata(llvm::LLVMContext::MD_tbaa, tbaaElement);
+            fast = load;
+        } else {
+            auto* store = builder.CreateAlignedStore(val, ptr, llvm::Align(4));
+            store->setMetadata(llvm::LLVMContext::MD_tbaa, tbaaElement);
+            result = store;                          // void-typed, like a void call
+        }
+        builder.CreateBr(doneBB);
+
+        // reduced-precision tensor: the runtime decodes / encodes the element
+        builder.SetInsertPoint(slowBB);
+        auto* r32 = builder.CreateTrunc(toIndex(row), i32Ty, "row");
+        auto* c32 = builder.CreateTrunc(toIndex(col), i32Ty, "col");
+        llvm::Value* slow = nullptr;
+        if (get) slow = builder.CreateCall(module->getFunction("ai_get_value"), {tensor, r32, c32}, "elem_rt");
+        else     builder.CreateCall(module->getFunction("ai_set_value"), {tensor, r32, c32, val});
+        builder.CreateBr(doneBB);
+
+        builder.SetInsertPoint(doneBB);
+        if (get) {
+            auto* phi = builder.CreatePHI(llvm::Type::getFloatTy(context), 2, "elem");
+            phi->addIncoming(fast, fastBB);
+            phi->addIncoming(slow, slowBB);
+            result = builder.CreateFPExt(phi, llvm::Type::getDoubleTy(context), "f2d");
+        }
+    }
+    releaseIfOwned(tensorArg, tensor);
+    return true;
+}
+
+// zeros(d0, d1, d2, …) / ones(…) with more than two sizes and
+// reshape(t, d0, d1, d2, …) with more than two build an N-d tensor: the sizes
+// are stored to a stack array and passed to the ai_*_nd runtime functions.
+bool CodeGen::generateShapeCall(CallExpr* call, llvm::Value*& result) {
+    const std::string& fn = call->callee;
+    size_t argc = call->arguments.size();
+    bool build   = (fn == "zeros" || fn == "ones") && argc > 2;
+    bool reshape = fn == "reshape" && argc > 3;
+    if (!build && !reshape) return false;
+
+    result = nullptr;
+    auto* i32Ty = llvm::Type::getInt32Ty(context);
+    Expr* tensorArg = reshape ? call->arguments[0].get() : nullptr;
+    llvm::Value* tensor = nullptr;
+    if (reshape) {
+        tensor = generateExpr(tensorArg);
+        if (!tensor || !tensor->getType()->isPointerTy()) {
+            std::cerr << "[CodeGen] ERROR: reshape expects a tensor as its first argument\n";
+            return true;
+        }
+    }
+
+    size_t first = reshape ? 1 : 0, ndim = argc - first;
+    auto* dimsTy = llvm::ArrayType::get(i32Ty, ndim);
+    auto* dims   = createEntryAlloca(dimsTy, "dims");
+    for (size_t d = 0; d < ndim; ++d) {
+        auto* v = generateExpr(call->arguments[first + d].get());
+        if (!v) return true;
+        auto* size = builder.CreateTrunc(toIndex(v), i32Ty, "dim");
+        builder.CreateStore(size, builder.CreateConstInBoundsGEP2_32(dimsTy, dims, 0, (unsigned)d));
+    }
+
+    auto* n = llvm::ConstantInt::get(i32Ty, ndim);
+    if (reshape) {
+        result = builder.CreateCall(module->getFunction("ai_reshape_nd"), {tensor, dims, n}, "reshape_nd");
+        releaseIfOwned(tensorArg, tensor);
+    } else {
+        auto* callee = module->getFunction(fn == "zeros" ? "ai_zeros_nd" : "ai_ones_nd");
+        result = builder.CreateCall(callee, {dims, n}, fn + "_nd");
+    }
+    return true;
+}
+
+// Lowers + - * / where at least one side is a tensor:
+//   tensor * tensor  → ai_matmul          (ai_matmul_2d for static 2-D shapes)
+//   tensor ⊕ tensor  → ai_add / ai_sub / ai_div   (broadcasting; ai_*_same
+//                      when both static shapes are known and identical)
+//   tensor ⊕ scalar  → ai_<op>_scalar
+//   scalar ⊕ tensor  → ai_<op>_scalar, or ai_r<op>_scalar for - and /
+llvm::Value* CodeGen::generateTensorBinary(BinaryExpr* bin, llvm::Value* L, llvm::Value* R) {
+    bool lTensor = bin->left->inferredType  && bin->left->inferredType->isTensor();
+    bool rTensor = bin->right->inferredType && bin->right->inferredType->isTensor();
+    const std::string& op = bin->op;
+
+    const char* opName = op == "+" ? "add" : op == "-" ? "sub"
+                       : op == "*" ? "mul" : op == "/" ? "div" : nullptr;
+    if (!opName) {
+        std::cerr << "[CodeGen] ERROR: operator '" << op << "' is not defined for tensors\n";
+        return nullptr;
+    }
+
+    llvm::Value* result = nullptr;
+    if (lTensor && rTensor) {
+        Type* lt = bin->left->inferredType;
+        Type* rt = bin->right->inferredType;
+        if (op == "*") {
+            auto* fn = module->getFunction(tensorOpEntry("matmul", lt, rt));
+            result = builder.CreateCall(fn, {L, R}, "matmul_tmp");
+        } else {
+            auto* fn = module->getFunction(tensorOpEntry(opName, lt, rt));
+            result = builder.CreateCall(fn, {L, R}, std::string(opName) + "_tmp");
+        }
+        releaseIfOwned(bin->left.get(),  L);
+        releaseIfOwned(bin->right.get(), R);
+        return result;
+    }
+
+    std::string fnName;
+    llvm::Value* tensor;
+    llvm::Value* scalar;
+    if (lTensor) {
+        fnName = std::string("ai_") + opName + "_scalar";
+        tensor = L; scalar = R;
+    } else {
+        bool ordered = op == "-" || op == "/";
+        fnName = std::string(ordered ? "ai_r" : "ai_") + opName + "_scalar";
+        tensor = R; scalar = L;
+    }
+    auto* fn = module->getFunction(fnName);
+    result = builder.CreateCall(fn, {tensor, toFloat(scalar)}, std::string(opName) + "_tmp");
+    releaseIfOwned(lTensor ? bin->left.get() : bin->right.get(), tensor);
+    return result;
+}
+
 // =============================
 // Expression Generation
 // =============================
@@ -743,27 +1422,57 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
     }
 
     // ── Tensor Literal ────────────────────────
+    // Constant elements go into a private [rows*cols x float] global that the
+    // runtime copies in one call; only non-constant elements are stored one
+    // by one afterwards. A literal with no constant elements starts from zeros.
     if (auto tensorLit = dynamic_cast<TensorLiteralExpr*>(expr)) {
         int rows = (int)tensorLit->rows.size();
         int cols = rows > 0 ? (int)tensorLit->rows[0].size() : 0;
+        auto* f32Ty = llvm::Type::getFloatTy(context);
 
-        auto tensorPtr = builder.CreateCall(
-            aiMatrixFunc, { builder.getInt32(rows), builder.getInt32(cols) }, "tensor_ptr"
-        );
-        auto* aiSetValueFunc = module->getFunction("ai_set_value");
+        std::vector<llvm::Constant*> init((size_t)rows * cols, llvm::ConstantFP::get(f32Ty, 0.0));
+        struct Slot { int row, col; llvm::Value* val; };
+        std::vector<Slot> dynamic;
+        size_t constants = 0;
 
         for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < (int)tensorLit->rows[i].size(); ++j) {
+            for (int j = 0; j < (int)tensorLit->rows[i].size() && j < cols; ++j) {
                 auto val = generateExpr(tensorLit->rows[i][j].get());
                 if (!val) continue;
-                if (val->getType()->isIntegerTy())
-                    val = builder.CreateSIToFP(val, llvm::Type::getFloatTy(context));
-                else if (val->getType()->isDoubleTy())
-                    val = builder.CreateFPTrunc(val, llvm::Type::getFloatTy(context));
-                builder.CreateCall(aiSetValueFunc,
-                    { tensorPtr, builder.getInt32(i), builder.getInt32(j), val });
+                val = toFloat(val);                          // folds when val is constant
+                auto* c = llvm::dyn_cast<llvm::Constant>(val);
+                if (c && c->getType()->isFloatTy()) {
+                    init[(size_t)i * cols + j] = c;
+                    ++constants;
+                } else {
+                    dynamic.push_back({i, j, val});
+                }
             }
         }
+
+        llvm::Value* tensorPtr;
+        if (constants == 0) {
+            tensorPtr = builder.CreateCall(
+                aiMatrixFunc, { builder.getInt32(rows), builder.getInt32(cols) }, "tensor_ptr"
+            );
+        } else {
+            auto* arrTy = llvm::ArrayType::get(f32Ty, init.size());
+            auto* data  = new llvm::GlobalVariable(
+                *module, arrTy, /*isConstant=*/true, llvm::GlobalValue::PrivateLinkage,
+                llvm::ConstantArray::get(arrTy, init), "tensor_lit"
+            );
+            data->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+            data->setAlignment(llvm::Align(64));
+            tensorPtr = builder.CreateCall(
+                module->getFunction("ai_from_data"),
+                { data, builder.getInt32(rows), builder.getInt32(cols) }, "tensor_ptr"
+            );
+        }
+
+        auto* aiSetValueFunc = module->getFunction("ai_set_value");
+        for (auto& s : dynamic)
+            builder.CreateCall(aiSetValueFunc,
+                { tensorPtr, builder.getInt32(s.row), builder.getInt32(s.col), s.val });
         return tensorPtr;
     }
 
@@ -775,8 +1484,8 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
 
         auto* lt = bin->left->inferredType;
         auto* rt = bin->right->inferredType;
-        if (lt && rt && lt->isTensor() && rt->isTensor() && bin->op == "*")
-            return builder.CreateCall(aiMatmulFunc, {L, R}, "matmul_tmp");
+        if ((lt && lt->isTensor()) || (rt && rt->isTensor()))
+            return generateTensorBinary(bin, L, R);
 
         bool lFP = L->getType()->isDoubleTy();
         bool rFP = R->getType()->isDoubleTy();
@@ -808,8 +1517,12 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
             return nullptr;
         }
 
-        if (var->inferredType && var->inferredType->isStruct())
+        // a struct variable's slot holds the instance pointer; `self` is one
+        if (var->inferredType && var->inferredType->isStruct()) {
+            if (llvm::isa<llvm::AllocaInst>(it->second))
+                return builder.CreateLoad(llvm::PointerType::get(context, 0), it->second, var->name);
             return it->second;
+        }
 
         llvm::Type* loadTy = nullptr;
         if (auto* allocaInst = llvm::dyn_cast<llvm::AllocaInst>(it->second))
@@ -826,8 +1539,17 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
     if (auto call = dynamic_cast<CallExpr*>(expr)) {
         std::string funcName = call->callee;
 
+        llvm::Value* inlined = nullptr;
+        if (generateTensorAccess(call, inlined)) return inlined;
+        if (generateShapeCall(call, inlined))    return inlined;
+
+        // sum / mean / max / min with an axis argument reduce along that axis
+        bool axisReduce = call->arguments.size() == 2 &&
+            (funcName == "sum" || funcName == "mean" || funcName == "max" || funcName == "min");
+
         // Nexa → runtime name mapping
-        if      (funcName == "zeros")      funcName = "ai_zeros";
+        if      (axisReduce)               funcName = "ai_" + funcName + "_axis";
+        else if (funcName == "zeros")      funcName = "ai_zeros";
         else if (funcName == "ones")       funcName = "ai_ones";
         else if (funcName == "sum")        funcName = "ai_sum";
         else if (funcName == "mean")       funcName = "ai_mean";
@@ -835,10 +1557,38 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
         else if (funcName == "min")        funcName = "ai_min";
         else if (funcName == "reshape")    funcName = "ai_reshape";
         else if (funcName == "shape")      funcName = "ai_shape";
+        else if (funcName == "transpose")  funcName = "ai_transpose";
+        else if (funcName == "det")        funcName = "ai_det";
+        else if (funcName == "inverse")    funcName = "ai_inverse";
+        else if (funcName == "ndim")       funcName = "ai_ndim";
+        else if (funcName == "to_f32")     funcName = "ai_to_f32";
+        else if (funcName == "to_bf16")    funcName = "ai_to_bf16";
+        else if (funcName == "to_f16")     funcName = "ai_to_f16";
+        else if (funcName == "quantize")   funcName = "ai_quantize";
+        else if (funcName == "dtype")      funcName = "ai_dtype";
+        else if (funcName == "dim")        funcName = "ai_dim";
         else if (funcName == "get_value")  funcName = "ai_get_value";
+        else if (funcName == "hadamard" || funcName == "matmul") {
+            Type* lt = call->arguments.size() == 2 ? call->arguments[0]->inferredType : nullptr;
+            Type* rt = call->arguments.size() == 2 ? call->arguments[1]->inferredType : nullptr;
+            funcName = tensorOpEntry(funcName == "hadamard" ? "mul" : "matmul", lt, rt);
+        }
+        else if (funcName == "argmax")     funcName = "ai_argmax";
         // ── CSV functions ──────────────────────
-        else if (funcName == "read_csv")   funcName = "csv_read";
-        else if (funcName == "write_csv")  funcName = "csv_write";
+        else if (funcName == "read_csv")   funcName = call->arguments.size() == 3 ? "csv_read_cols" : "csv_read";
+        else if (funcName == "write_csv")  funcName = call->arguments.size() == 3 ? "csv_write_digits" : "csv_write";
+        else if (funcName == "csv_open")       funcName = call->arguments.size() == 3 ? "csv_open_cols" : "csv_open";
+        else if (funcName == "csv_next_batch") funcName = "csv_next_batch";
+        else if (funcName == "csv_close")      funcName = "csv_close";
+        else if (funcName == "read_table")  funcName = "csv_read_table";
+        else if (funcName == "table_data")  funcName = "table_data";
+        else if (funcName == "table_col")   funcName = "table_col";
+        else if (funcName == "table_index") funcName = "table_index";
+        else if (funcName == "table_label") funcName = "table_label";
+        else if (funcName == "save_tensor") funcName = "save_tensor";
+        else if (funcName == "load_tensor") funcName = "load_tensor";
+        else if (funcName == "remove_file") funcName = "nexa_file_remove";
+        else if (funcName == "file_exists") funcName = "nexa_file_exists";
         else if (funcName == "csv_rows")   funcName = "csv_rows";
         else if (funcName == "csv_cols")   funcName = "csv_cols";
         else if (funcName == "csv_get")    funcName = "csv_get";
@@ -847,8 +1597,22 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
         else if (funcName == "csv_col")    funcName = "csv_get_col";
         else if (funcName == "csv_slice")  funcName = "csv_slice_cols";
         // ── ML functions ───────────────────────
-        else if (funcName == "normalize")       funcName = "ml_normalize";
-        else if (funcName == "shuffle")         funcName = "ml_shuffle";
+        else if (funcName == "normalize")       funcName = call == reuseCall ? "ml_normalize_reuse" : "ml_normalize";
+        else if (funcName == "standardize")     funcName = call == reuseCall ? "ml_standardize_reuse" : "ml_standardize";
+        else if (funcName == "robust_scale")    funcName = call == reuseCall ? "ml_robust_scale_reuse" : "ml_robust_scale";
+        else if (funcName == "shuffle")         funcName = call == reuseCall ? "ml_shuffle_reuse" : "ml_shuffle";
+        else if (funcName == "clip")            funcName = call == reuseCall ? "ml_clip_reuse" : "ml_clip";
+        else if (funcName == "normalize_")      funcName = "ml_normalize_";
+        else if (funcName == "standardize_")    funcName = "ml_standardize_";
+        else if (funcName == "robust_scale_")   funcName = "ml_robust_scale_";
+        else if (funcName == "shuffle_")        funcName = "ml_shuffle_";
+        else if (funcName == "scale_")          funcName = "ml_scale_";
+        else if (funcName == "clip_")           funcName = "ml_clip_";
+        else if (funcName == "minmax_scaler")   funcName = "ml_minmax_scaler";
+        else if (funcName == "standard_scaler") funcName = "ml_standard_scaler";
+        else if (funcName == "robust_scaler")   funcName = "ml_robust_scaler";
+        else if (funcName == "transform")       funcName = "ml_transform";
+        else if (funcName == "transform_")      funcName = "ml_transform_";
         else if (funcName == "train_split")     funcName = "ml_train_split";
         else if (funcName == "test_split")      funcName = "ml_test_split";
         else if (funcName == "hstack")          funcName = "ml_hstack";
@@ -860,6 +1624,12 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
         else if (funcName == "confusion")       funcName = "ml_confusion";
         else if (funcName == "weights")         funcName = "lore_weights";
         else if (funcName == "bias")            funcName = "lore_bias";
+        // ── Threading ──────────────────────────
+        else if (funcName == "set_threads")     funcName = "nexa_set_num_threads";
+        else if (funcName == "num_threads")     funcName = "nexa_get_num_threads";
+        else if (funcName == "alloc_stats")     funcName = "nexa_alloc_stats";
+        else if (funcName == "alloc_trim")      funcName = "nexa_alloc_trim";
+        else if (funcName == "set_lazy")        funcName = "nexa_set_lazy";
 
         auto* fn = module->getFunction(funcName);
         if (!fn) {
@@ -884,12 +1654,20 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
                     val = builder.CreateFPExt(val, llvm::Type::getDoubleTy(context), "f2d");
                 else if (expected->isIntegerTy(32) && actual->isIntegerTy(1))
                     val = builder.CreateZExt(val, llvm::Type::getInt32Ty(context), "b2i");
+                else if (expected->isFloatingPointTy() && actual->isIntegerTy(32))
+                    val = builder.CreateSIToFP(val, expected, "i2f");
             }
             args.push_back(val);
         }
         // Void-returning functions must NOT get a result name — LLVM verifier rejects it
         bool isVoid = fn->getReturnType()->isVoidTy();
-        return builder.CreateCall(fn, args, isVoid ? "" : "calltmp");
+        llvm::Value* result = builder.CreateCall(fn, args, isVoid ? "" : "calltmp");
+        for (size_t i = 0; i < args.size(); ++i)
+            releaseIfOwned(call->arguments[i].get(), args[i]);
+        // Nexa has no float type: runtime float results are doubles to the analyzer
+        if (result->getType()->isFloatTy())
+            result = builder.CreateFPExt(result, llvm::Type::getDoubleTy(context), "f2d");
+        return result;
     }
 
     // ── Struct Literal ────────────────────────
@@ -900,7 +1678,8 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
             return nullptr;
         }
         auto* st     = it->second;
-        auto* alloca = builder.CreateAlloca(st, nullptr, sl->structName + "_tmp");
+        auto* alloca = createEntryAlloca(st, sl->structName + "_tmp");
+        builder.CreateStore(llvm::Constant::getNullValue(st), alloca);   // unset fields stay null
         auto& fieldIdx = structFields[sl->structName];
 
         for (auto& f : sl->fields) {
@@ -910,6 +1689,7 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
             if (idx == -1) { std::cerr << "[CodeGen] ERROR: unknown field '" << f.first << "'\n"; continue; }
             auto val = generateExpr(f.second.get());
             if (!val) continue;
+            val = retainIfBorrowed(f.second.get(), val);
             auto ptr = builder.CreateStructGEP(st, alloca, idx, f.first + "_ptr");
             builder.CreateStore(val, ptr);
         }
@@ -951,7 +1731,8 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
             std::cerr << "[CodeGen] ERROR: unknown struct '" << cc->structName << "'\n";
             return nullptr;
         }
-        auto* alloca   = builder.CreateAlloca(st, nullptr, cc->structName + "_inst");
+        auto* alloca   = createEntryAlloca(st, cc->structName + "_inst");
+        builder.CreateStore(llvm::Constant::getNullValue(st), alloca);   // fields start null
         auto* ctorFunc = module->getFunction(cc->structName + "__ctor");
         if (ctorFunc) {
             std::vector<llvm::Value*> args = { alloca };
@@ -961,6 +1742,8 @@ llvm::Value* CodeGen::generateExpr(Expr* expr)
                 args.push_back(val);
             }
             builder.CreateCall(ctorFunc, args);
+            for (size_t i = 0; i < cc->arguments.size(); ++i)
+                releaseIfOwned(cc->arguments[i].get(), args[i + 1]);
         }
         return alloca;
     }
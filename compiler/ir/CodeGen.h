@@ -38,6 +38,7 @@ private:
     // ── Struct support ────────────────────────
     std::unordered_map<std::string, llvm::StructType*>                   structTypes;
     std::unordered_map<std::string, std::vector<std::pair<std::string,int>>> structFields;
+    std::unordered_map<std::string, std::vector<int>>                    structTensorFields;
 
     // ── External runtime functions ────────────
     llvm::Function* printfFunc       = nullptr;
@@ -46,6 +47,34 @@ private:
     llvm::Function* aiMatrixFunc     = nullptr;
     llvm::Function* aiMatmulFunc     = nullptr;
     llvm::Function* aiPrintTensorFunc= nullptr;
+    llvm::Function* aiRetainFunc     = nullptr;
+    llvm::Function* aiReleaseFunc    = nullptr;
+
+    // ── Tensor ABI ────────────────────────────
+    // Mirrors nexa::TensorHeader (runtime/ai/Tensor.h):
+    //   { i32 refs, ptr destroy, ptr elems, i64 rows, i64 cols, i64 rowStride, i64 colStride }
+    // Header loads and element loads/stores get distinct TBAA tags, so LLVM
+    // knows element stores never change the header and can hoist its loads.
+    enum TensorField { TF_Elems = 2, TF_Rows, TF_Cols, TF_RowStride, TF_ColStride };
+    llvm::StructType* tensorHeaderTy = nullptr;
+    llvm::MDNode*     tbaaHeader     = nullptr;
+    llvm::MDNode*     tbaaElement    = nullptr;
+
+    // ── Lexical scopes / tensor ownership ─────
+    // Every tensor variable owns one reference, and every struct variable
+    // owns its instance and one reference per tensor field. A scope remembers
+    // the tensor and struct slots declared in it (released when the scope
+    // closes) and the bindings it shadowed (restored when it closes).
+    struct Scope {
+        std::vector<llvm::AllocaInst*>                     tensorSlots;
+        std::vector<std::pair<llvm::AllocaInst*, std::string>> structSlots;
+        std::vector<std::pair<std::string, llvm::Value*>>  shadowed;
+    };
+    std::vector<Scope> scopes;   // innermost last; reset per function
+
+    // The call in `x = f(x, ...)` being generated: its old argument dies with
+    // the assignment, so f may reuse the buffer (ml_*_reuse)
+    CallExpr* reuseCall = nullptr;
 
     // ── File module state ─────────────────────
     bool fileModuleImported = false;
@@ -55,13 +84,40 @@ private:
     void         declareFileRuntime();
     void         declareCsvRuntime();
     void         declareMlRuntime();     // ← new
+    void         declareParallelRuntime();
+    void         declareElementwiseRuntime();
+    void         declareReduceRuntime();
+    void         declareShapeRuntime();
+    llvm::Value* toFloat(llvm::Value* v);
+    llvm::Value* toIndex(llvm::Value* v);     // any scalar → i64
+
+    // ── Inline tensor access ──────────────────
+    llvm::Value* loadTensorField(llvm::Value* tensor, TensorField field, const std::string& name);
+    llvm::Value* tensorElementPtr(llvm::Value* tensor, llvm::Value* elems, llvm::Value* row, llvm::Value* col);
+    bool         generateTensorAccess(CallExpr* call, llvm::Value*& result);
+    bool         generateShapeCall(CallExpr* call, llvm::Value*& result);
+
+    // ── Scopes & reference counting ───────────
+    llvm::AllocaInst* createEntryAlloca(llvm::Type* type, const std::string& name);
+    void         pushScope();
+    void         popScope();                  // releases the scope's tensors if the block is open
+    void         releaseScopes(size_t from);  // emit releases for scopes[from..] (no pop)
+    void         declareVariable(const std::string& name, llvm::AllocaInst* slot, bool isTensor);
+    void         declareStruct(const std::string& name, llvm::AllocaInst* slot, const std::string& structName);
+    bool         ownsStruct(Expr* expr);      // fresh instance (literal, constructor call)?
+    void         structFieldRefs(llvm::Function* fn, const std::string& structName, llvm::Value* instance);
+    bool         ownsTensor(Expr* expr);      // fresh +1 tensor (call, literal, operator)?
+    llvm::Value* retainIfBorrowed(Expr* expr, llvm::Value* val);
+    void         releaseIfOwned(Expr* expr, llvm::Value* val);
 
     // ── Code generation ───────────────────────
     llvm::Value* generateExpr(Expr* expr);
     llvm::Value* generateFileExpr(FileExpr* fe);
+    llvm::Value* generateTensorBinary(BinaryExpr* bin, llvm::Value* L, llvm::Value* R);
+    std::string  tensorOpEntry(const std::string& opName, Type* l, Type* r);
     void         generateStmt(Stmt* stmt);
 };
 
 } // namespace nexa
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -166,11 +166,13 @@ static void compileToIR(const std::string& source, const std::string& irPath) {
 
     // ── Stage 3: Semantic analysis ────────────
     vlog("stage 3/4 — semantic analysis");
+    SemanticAnalyzer sema;
     try {
-        SemanticAnalyzer sema;
         sema.analyze(*program);
     } catch (const std::exception& e) { die(std::string("sema: ") + e.what()); }
       catch (...)                      { die("sema: unknown exception"); }
+    if (int n = sema.shapeErrors())
+        die("aborting due to " + std::to_string(n) + " tensor shape error" + (n == 1 ? "" : "s"));
     vlog("sema OK");
 
     // ── Stage 4: IR generation ────────────────
@@ -312,9 +314,9 @@ int main(int argc, char** argv) {
         vlog("runtime: " + runtimeLib);
 
     // ── Step 3: Link ──────────────────────────
-    std::string linkCmd = "clang++ -O1 " + irFile;
+    std::string linkCmd = "clang++ -O2 " + irFile;   // -O2: loop vectoriser for inline tensor access
     if (hasRuntime) linkCmd += " " + runtimeLib;
-    linkCmd += " -lm -lstdc++ -o " + exeFile;  // -lstdc++ needed for Tensor.cpp (std::vector, cout)
+    linkCmd += " -lm -lstdc++ -lpthread -o " + exeFile;  // -lstdc++ for Tensor.cpp (std::vector, cout), -lpthread for the kernel thread pool
     if (!verbose) linkCmd += " 2>&1";
 
     if (execCmd(linkCmd, "linking") != 0) {
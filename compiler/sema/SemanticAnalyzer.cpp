@@ -1,4 +1,5 @@
 #include "SemanticAnalyzer.h"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
@@ -8,7 +9,169 @@ static nexa::Type TYPE_INT_ARRAY(nexa::TypeKind::Array, &nexa::TYPE_INT);
 
 std::map<std::string, Type*> structTypeCache;
 
+// ── Static tensor shapes ──────────────────────────────────────────────────────
+// Mirrors the runtime rules (runtime/ai/Tensor.cpp, Elementwise.cpp), so a
+// mismatch the runtime would report on every run is reported here instead.
+
+static std::string dimsStr(const std::vector<int>& d) { return tensorType(d)->shapeString(); }
+
+// Integer literal (possibly parenthesised)
+static bool constInt(Expr* e, int& v) {
+    if (auto g = dynamic_cast<GroupingExpr*>(e)) return constInt(g->expression.get(), v);
+    if (auto i = dynamic_cast<IntegerLiteral*>(e)) { v = i->value; return true; }
+    return false;
+}
+
+// Element-wise broadcasting: shapes align on the last dimension, sizes
+// match or one is 1; results have at least two dimensions.
+static bool broadcastDims(const std::vector<int>& a, const std::vector<int>& b, std::vector<int>& out) {
+    size_t nd = std::max({a.size(), b.size(), (size_t)2});
+    out.assign(nd, 1);
+    for (size_t d = 0; d < nd; ++d) {
+        int x = d + a.size() >= nd ? a[d + a.size() - nd] : 1;
+        int y = d + b.size() >= nd ? b[d + b.size() - nd] : 1;
+        if (x != y && x != 1 && y != 1) return false;
+        out[d] = x == 1 ? y : x;
+    }
+    return true;
+}
+
+// Matrix product over the last two dimensions, batch dimensions broadcast
+static bool matmulDims(const std::vector<int>& a, const std::vector<int>& b, std::vector<int>& out) {
+    size_t na = a.size(), nb = b.size();
+    if (na < 2 || nb < 2 || a[na - 1] != b[nb - 2]) return false;
+    std::vector<int> batch;
+    if (!broadcastDims(std::vector<int>(a.begin(), a.end() - 2), std::vector<int>(b.begin(), b.end() - 2), batch))
+        return false;
+    if (std::max(na, nb) == 2) batch.clear();
+    else batch.erase(batch.begin(), batch.end() - (std::max(na, nb) - 2));
+    out = batch;
+    out.push_back(a[na - 2]);
+    out.push_back(b[nb - 1]);
+    return true;
+}
+
+static size_t dimsProduct(const std::vector<int>& d) {
+    size_t n = 1;
+    for (int x : d) n *= (size_t)x;
+    return n;
+}
+
+void SemanticAnalyzer::shapeError(const std::string& msg) {
+    std::cerr << "[sema] error: " << msg << "\n";
+    ++shapeErrorCount;
+}
+
+void SemanticAnalyzer::collectAssigned(const std::vector<std::unique_ptr<Stmt>>& stmts) {
+    for (auto& stmt : stmts) {
+        if (auto a = dynamic_cast<AssignmentStmt*>(stmt.get())) {
+            if (auto v = dynamic_cast<VariableExpr*>(a->target.get())) reassigned.insert(v->name);
+        } else if (auto l = dynamic_cast<LoopStmt*>(stmt.get())) {
+            collectAssigned(l->body);
+        } else if (auto i = dynamic_cast<IfStmt*>(stmt.get())) {
+            collectAssigned(i->thenBranch);
+            collectAssigned(i->elseBranch);
+        } else if (auto f = dynamic_cast<FunctionDecl*>(stmt.get())) {
+            collectAssigned(f->body);
+        } else if (auto sd = dynamic_cast<StructDecl*>(stmt.get())) {
+            if (sd->constructor) collectAssigned(sd->constructor->body);
+        }
+    }
+}
+
+// + - * / with at least one tensor operand; * between tensors is matmul
+Type* SemanticAnalyzer::tensorBinaryType(const std::string& op, Type* l, Type* r) {
+    if (!l->isTensor()) return r->hasShape() ? r : &TYPE_TENSOR;      // scalar ⊕ tensor
+    if (!r->isTensor()) return l->hasShape() ? l : &TYPE_TENSOR;      // tensor ⊕ scalar
+    if (!l->hasShape() || !r->hasShape()) return &TYPE_TENSOR;
+    std::vector<int> out;
+    if (op == "*") {
+        if (matmulDims(l->dims, r->dims, out)) return tensorType(out);
+        shapeError("matmul shape mismatch: " + l->shapeString() + " * " + r->shapeString());
+    } else {
+        if (broadcastDims(l->dims, r->dims, out)) return tensorType(out);
+        shapeError("'" + op + "' shape mismatch: " + l->shapeString() + " vs " + r->shapeString());
+    }
+    return &TYPE_TENSOR;
+}
+
+// Static result shape of a tensor builtin, where the arguments determine it
+Type* SemanticAnalyzer::tensorCallType(CallExpr* call) {
+    const std::string& fn = call->callee;
+    auto& args = call->arguments;
+    auto argType = [&](size_t i) -> Type* {
+        Type* t = i < args.size() ? args[i]->inferredType : nullptr;
+        return t && t->isTensor() ? t : &TYPE_TENSOR;
+    };
+    std::vector<int> dims;
+
+    if (fn == "zeros" || fn == "ones") {
+        for (auto& a : args) {
+            int v;
+            if (!constInt(a.get(), v)) return &TYPE_TENSOR;
+            if (v < 0) { shapeError(fn + ": negative dimension " + std::to_string(v)); return &TYPE_TENSOR; }
+            dims.push_back(v);
+        }
+        return tensorType(dims);
+    }
+    if (fn == "reshape" && args.size() >= 2) {
+        for (size_t i = 1; i < args.size(); ++i) {
+            int v;
+            if (!constInt(args[i].get(), v) || v < 0) return &TYPE_TENSOR;
+            dims.push_back(v);
+        }
+        Type* src = argType(0);
+        if (src->hasShape() && dimsProduct(src->dims) != dimsProduct(dims)) {
+            shapeError("reshape: cannot view " + src->shapeString() + " as " + dimsStr(dims));
+            return &TYPE_TENSOR;
+        }
+        return tensorType(dims);
+    }
+
+    Type* t = argType(fn == "transform" ? 1 : 0);     // transform(scaler, X)
+    if (fn == "matmul" && args.size() == 2) return tensorBinaryType("*", t, argType(1));
+    if (fn == "hadamard" && args.size() == 2) return tensorBinaryType("hadamard", t, argType(1));
+    if (!t->hasShape()) return &TYPE_TENSOR;
+    dims = t->dims;
+
+    if (fn == "transpose") {
+        if (dims.size() == 1) return tensorType({dims[0], 1});
+        std::swap(dims[dims.size() - 2], dims[dims.size() - 1]);
+        return tensorType(dims);
+    }
+    if (fn == "inverse" || fn == "det") {
+        if (dims.size() != 2 || dims[0] != dims[1]) {
+            shapeError(fn + ": expected a square matrix, got " + t->shapeString());
+            return &TYPE_TENSOR;
+        }
+        return t;
+    }
+    if (fn == "to_f32" || fn == "to_bf16" || fn == "to_f16" || fn == "quantize")
+        return t;
+    if (fn == "normalize" || fn == "standardize" || fn == "robust_scale" || fn == "transform" ||
+        fn == "shuffle" || fn == "clip") {                          // dense [rows x cols] copies
+        int cols = dims.back();
+        return tensorType({(int)(dimsProduct(dims) / std::max(cols, 1)), cols});
+    }
+    if (fn == "shape") return tensorType({1, (int)dims.size()});
+
+    // axis reductions see the tensor as [rows x cols]
+    int axis;
+    bool reduction = fn == "sum" || fn == "mean" || fn == "max" || fn == "min" || fn == "argmax";
+    if (reduction && args.size() == 2 && constInt(args[1].get(), axis)) {
+        if (axis != 0 && axis != 1) {
+            shapeError(fn + ": axis must be 0 or 1, got " + std::to_string(axis));
+            return &TYPE_TENSOR;
+        }
+        int cols = dims.back(), rows = (int)(dimsProduct(dims) / std::max(cols, 1));
+        if (dims.size() == 1) rows = 1;
+        return axis == 0 ? tensorType({1, cols}) : tensorType({rows, 1});
+    }
+    return &TYPE_TENSOR;
+}
+
 void SemanticAnalyzer::analyze(Program& program) {
+    collectAssigned(program.statements);
     pushScope();
     for (auto& stmt : program.statements)
         checkStmt(stmt.get());
@@ -22,7 +185,12 @@ void SemanticAnalyzer::checkStmt(Stmt* stmt) {
     if (auto varDecl = dynamic_cast<VarDeclStmt*>(stmt)) {
         if (varDecl->initializer)
             checkExpr(varDecl->initializer.get());
-        declare(varDecl->name, varDecl->declaredType);
+        Type* type = varDecl->declaredType;
+        Type* init = varDecl->initializer ? varDecl->initializer->inferredType : nullptr;
+        // a tensor that is never reassigned keeps its initializer's static shape
+        if (type && type->isTensor() && init && init->hasShape() && !reassigned.count(varDecl->name))
+            type = init;
+        declare(varDecl->name, type);
         return;
     }
 
@@ -101,6 +269,14 @@ void SemanticAnalyzer::checkStmt(Stmt* stmt) {
         structRegistry[sd->name] = sd->fields;
         if (structTypeCache.find(sd->name) == structTypeCache.end())
             structTypeCache[sd->name] = new Type(TypeKind::Struct, sd->name);
+        if (sd->constructor) {
+            pushScope();
+            declare("self", structTypeCache[sd->name]);
+            for (auto& [paramName, paramType] : sd->constructor->params)
+                declare(paramName, paramType);
+            for (auto& s : sd->constructor->body) checkStmt(s.get());
+            popScope();
+        }
         return;
     }
 
@@ -157,6 +333,15 @@ void SemanticAnalyzer::checkExpr(Expr* expr) {
         for (auto& row : tensorLit->rows)
             for (auto& elem : row) checkExpr(elem.get());
         expr->inferredType = &TYPE_TENSOR;
+        auto& rows = tensorLit->rows;
+        for (auto& row : rows) {
+            if (row.size() != rows[0].size()) {
+                shapeError("tensor literal rows have different lengths (" + std::to_string(rows[0].size()) +
+                           " and " + std::to_string(row.size()) + ")");
+                return;
+            }
+        }
+        if (!rows.empty()) expr->inferredType = tensorType({(int)rows.size(), (int)rows[0].size()});
         return;
     }
 
@@ -184,9 +369,25 @@ void SemanticAnalyzer::checkExpr(Expr* expr) {
         if (!lType) lType = rType;
         if (!rType) rType = lType;
 
-        if      (lType->isTensor() || rType->isTensor()) expr->inferredType = &TYPE_TENSOR;
-        else if (lType->isDouble()  || rType->isDouble()) expr->inferredType = &TYPE_DOUBLE;
-        else                                              expr->inferredType = &TYPE_INT;
+        if (lType->isTensor() || rType->isTensor()) {
+            // Tensors support + - * / against tensors (broadcasting; * is matmul)
+            // and numeric scalars — lowered to ai_* runtime calls by CodeGen.
+            const std::string& op = bin->op;
+            bool arith = op == "+" || op == "-" || op == "*" || op == "/";
+            auto numericOrTensor = [](Type* t) {
+                return t->isTensor() || t->isInt() || t->isDouble() || t->isBool();
+            };
+            if (!arith)
+                std::cerr << "[sema] error: operator '" << op << "' is not defined for tensors\n";
+            else if (!numericOrTensor(lType) || !numericOrTensor(rType))
+                std::cerr << "[sema] error: cannot apply '" << op << "' to "
+                          << lType->toString() << " and " << rType->toString() << "\n";
+            expr->inferredType = arith ? tensorBinaryType(op, lType, rType) : &TYPE_TENSOR;
+        } else if (lType->isDouble() || rType->isDouble()) {
+            expr->inferredType = &TYPE_DOUBLE;
+        } else {
+            expr->inferredType = &TYPE_INT;
+        }
         return;
     }
 
@@ -197,6 +398,11 @@ void SemanticAnalyzer::checkExpr(Expr* expr) {
         const std::string& fn = call->callee;
 
         // CSV functions — return types
+        if ((fn == "read_csv" || fn == "csv_open") && call->arguments.size() == 3) {
+            Type* cols = call->arguments[2]->inferredType;
+            if (cols && !cols->isTensor())
+                shapeError(fn + ": the column list must be a tensor, e.g. [[0, 2]]");
+        }
         if (fn == "read_csv")  { expr->inferredType = &TYPE_TENSOR; return; }
         if (fn == "csv_row")   { expr->inferredType = &TYPE_TENSOR; return; }
         if (fn == "csv_col")   { expr->inferredType = &TYPE_TENSOR; return; }
@@ -205,11 +411,34 @@ void SemanticAnalyzer::checkExpr(Expr* expr) {
         if (fn == "csv_rows")  { expr->inferredType = &TYPE_INT;    return; }
         if (fn == "csv_cols")  { expr->inferredType = &TYPE_INT;    return; }
         if (fn == "write_csv") { expr->inferredType = &TYPE_VOID;   return; }
+        if (fn == "csv_open")       { expr->inferredType = &TYPE_TENSOR; return; }   // opaque cursor
+        if (fn == "csv_next_batch") { expr->inferredType = &TYPE_TENSOR; return; }
+        if (fn == "csv_close")      { expr->inferredType = &TYPE_VOID;   return; }
+        if (fn == "read_table")  { expr->inferredType = &TYPE_TENSOR; return; }   // opaque table
+        if (fn == "table_data")  { expr->inferredType = &TYPE_TENSOR; return; }
+        if (fn == "table_col")   { expr->inferredType = &TYPE_TENSOR; return; }
+        if (fn == "table_index") { expr->inferredType = &TYPE_INT;    return; }
+        if (fn == "table_label") { expr->inferredType = &TYPE_STRING; return; }
+        if (fn == "load_tensor") { expr->inferredType = &TYPE_TENSOR; return; }
+        if (fn == "save_tensor") { expr->inferredType = &TYPE_VOID;   return; }
+        if (fn == "remove_file") { expr->inferredType = &TYPE_VOID;   return; }
+        if (fn == "file_exists") { expr->inferredType = &TYPE_INT;    return; }
         if (fn == "csv_set")   { expr->inferredType = &TYPE_VOID;   return; }
+        if (fn == "set_value") { expr->inferredType = &TYPE_VOID;   return; }
 
         // ML functions — return types
-        if (fn == "normalize")     { expr->inferredType = &TYPE_TENSOR; return; }
-        if (fn == "shuffle")       { expr->inferredType = &TYPE_TENSOR; return; }
+        if (fn == "normalize")     { expr->inferredType = tensorCallType(call); return; }
+        if (fn == "standardize")   { expr->inferredType = tensorCallType(call); return; }
+        if (fn == "robust_scale")  { expr->inferredType = tensorCallType(call); return; }
+        if (fn == "shuffle")       { expr->inferredType = tensorCallType(call); return; }
+        if (fn == "clip")          { expr->inferredType = tensorCallType(call); return; }
+        if (fn == "normalize_" || fn == "standardize_" || fn == "robust_scale_" ||
+            fn == "shuffle_" || fn == "scale_" || fn == "clip_")
+                                   { expr->inferredType = &TYPE_VOID;   return; }   // in place
+        if (fn == "minmax_scaler" || fn == "standard_scaler" || fn == "robust_scaler")
+                                   { expr->inferredType = &TYPE_TENSOR; return; }   // scaler as opaque tensor
+        if (fn == "transform")     { expr->inferredType = tensorCallType(call); return; }
+        if (fn == "transform_")    { expr->inferredType = &TYPE_VOID;   return; }
         if (fn == "train_split")   { expr->inferredType = &TYPE_TENSOR; return; }
         if (fn == "test_split")    { expr->inferredType = &TYPE_TENSOR; return; }
         if (fn == "hstack")        { expr->inferredType = &TYPE_TENSOR; return; }
@@ -222,13 +451,34 @@ void SemanticAnalyzer::checkExpr(Expr* expr) {
         if (fn == "weights")       { expr->inferredType = &TYPE_TENSOR; return; }
         if (fn == "bias")          { expr->inferredType = &TYPE_DOUBLE; return; }
 
+        // Threading
+        if (fn == "set_threads")   { expr->inferredType = &TYPE_VOID;   return; }
+        if (fn == "num_threads")   { expr->inferredType = &TYPE_INT;    return; }
+        if (fn == "alloc_stats")   { expr->inferredType = &TYPE_VOID;   return; }
+        if (fn == "alloc_trim")    { expr->inferredType = &TYPE_VOID;   return; }
+        if (fn == "set_lazy")      { expr->inferredType = &TYPE_VOID;   return; }
+
         // Tensor/AI functions
+        bool reduction = fn == "sum" || fn == "mean" || fn == "max" || fn == "min";
+        if (reduction && call->arguments.size() == 2)       // reduce along an axis
+            { expr->inferredType = tensorCallType(call); return; }
+        if (fn == "argmax")
+            { expr->inferredType = tensorCallType(call); return; }
         if (fn == "zeros"   || fn == "ones"    || fn == "reshape" ||
-            fn == "shape"   || fn == "matmul")
-            { expr->inferredType = &TYPE_TENSOR; return; }
+            fn == "shape"   || fn == "matmul"  || fn == "hadamard" ||
+            fn == "transpose" || fn == "inverse")
+            { expr->inferredType = tensorCallType(call); return; }
         if (fn == "sum"     || fn == "mean"    || fn == "max"     ||
             fn == "min"     || fn == "get_value")
             { expr->inferredType = &TYPE_DOUBLE; return; }
+        if (fn == "det")                                    // checks the static shape
+            { tensorCallType(call); expr->inferredType = &TYPE_DOUBLE; return; }
+        if (fn == "ndim"    || fn == "dim")
+            { expr->inferredType = &TYPE_INT;    return; }
+        if (fn == "to_f32"  || fn == "to_bf16" || fn == "to_f16"  || fn == "quantize")
+            { expr->inferredType = tensorCallType(call); return; }
+        if (fn == "dtype")
+            { expr->inferredType = &TYPE_STRING; return; }
 
         // User-defined or unknown — look up in symbol table
         Type* retType = lookup(fn);
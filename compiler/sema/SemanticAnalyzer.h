@@ -1,6 +1,7 @@
 #pragma once
 #include "../ast/Ast.h"
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -12,12 +13,26 @@ public:
     void checkExpr(Expr* expr);
     void checkStmt(Stmt* stmt);
 
+    // Tensor shape errors found at compile time (each already reported)
+    int shapeErrors() const { return shapeErrorCount; }
+
 private:
     // Scope stack: each entry maps variable name → Type*
     // push on entering a block, pop on leaving
     std::vector<std::map<std::string, Type*>> symbolStack;
     std::map<std::string, std::vector<std::pair<std::string, Type*>>> structRegistry;
 
+    // ── Static tensor shapes ──────────────────
+    // Variables assigned after their declaration never get a static shape:
+    // the value could change shape from one iteration to the next.
+    std::set<std::string> reassigned;
+    int shapeErrorCount = 0;
+
+    void  collectAssigned(const std::vector<std::unique_ptr<Stmt>>& stmts);
+    void  shapeError(const std::string& msg);
+    Type* tensorBinaryType(const std::string& op, Type* l, Type* r);
+    Type* tensorCallType(CallExpr* call);
+
     // ── Scope helpers ─────────────────────────
     void pushScope()  { symbolStack.push_back({}); }
     void popScope()   { symbolStack.pop_back(); }
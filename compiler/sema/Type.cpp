@@ -1,4 +1,5 @@
 #include "Type.h"
+#include <map>
 
 namespace nexa {
 
@@ -12,4 +13,12 @@ Type TYPE_VOID   (TypeKind::Void);
 Type TYPE_TENSOR (TypeKind::Tensor);
 Type TYPE_INT_ARRAY(TypeKind::Array, &TYPE_INT);   // int[]
 
+Type* tensorType(const std::vector<int>& dims) {
+    if (dims.empty()) return &TYPE_TENSOR;
+    static std::map<std::vector<int>, Type*> interned;
+    Type*& t = interned[dims];
+    if (!t) t = new Type(TypeKind::Tensor, dims);
+    return t;
+}
+
 } // namespace nexa
\ No newline at end of file
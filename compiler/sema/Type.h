@@ -2,6 +2,7 @@
 #define NEXA_TYPE_H
 
 #include <string>
+#include <vector>
 
 namespace nexa {
 
@@ -20,10 +21,14 @@ struct Type {
     TypeKind kind;
     Type*    elementType = nullptr;
     std::string structName;
+    // Tensor only: static shape when sema can infer it (literals, constant
+    // zeros/ones/reshape sizes, and the ops below); empty = unknown.
+    std::vector<int> dims;
 
     Type(TypeKind k)                        : kind(k), elementType(nullptr) {}
     Type(TypeKind k, Type* elem)            : kind(k), elementType(elem)    {}
     Type(TypeKind k, const std::string& sn) : kind(k), structName(sn) {}
+    Type(TypeKind k, std::vector<int> d)    : kind(k), dims(std::move(d)) {}
 
     bool isInt()    const { return kind == TypeKind::Int;    }
     bool isDouble() const { return kind == TypeKind::Double; }
@@ -33,6 +38,7 @@ struct Type {
     bool isVoid()   const { return kind == TypeKind::Void;   }
     bool isTensor() const { return kind == TypeKind::Tensor; }
     bool isStruct() const { return kind == TypeKind::Struct; }
+    bool hasShape() const { return isTensor() && !dims.empty(); }
 
     std::string toString() const {
         switch (kind) {
@@ -42,11 +48,19 @@ struct Type {
             case TypeKind::Bool:   return "bool";
             case TypeKind::Array:  return (elementType ? elementType->toString() : "?") + "[]";
             case TypeKind::Void:   return "void";
-            case TypeKind::Tensor: return "tensor";
+            case TypeKind::Tensor: return "tensor" + shapeString();
             case TypeKind::Struct: return structName;
         }
         return "unknown";
     }
+
+    // "[2 x 3]" for a tensor with a static shape, "" otherwise
+    std::string shapeString() const {
+        if (dims.empty()) return "";
+        std::string s = "[";
+        for (size_t i = 0; i < dims.size(); ++i) s += (i ? " x " : "") + std::to_string(dims[i]);
+        return s + "]";
+    }
 };
 
 // ── Singleton type instances ───────────────────────────────────────────────
@@ -61,6 +75,10 @@ extern Type TYPE_VOID;
 extern Type TYPE_TENSOR;
 extern Type TYPE_INT_ARRAY;   // int[]
 
+// Tensor type with a static shape. Interned: equal shapes give the same
+// object. An empty shape gives TYPE_TENSOR.
+Type* tensorType(const std::vector<int>& dims);
+
 } // namespace nexa
 
 #endif
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "Allocator.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define NEXA_HAVE_MMAP 1
+#endif
+
+namespace nexa {
+
+// ── Size classes ──────────────────────────────────────────────────────────────
+// Class 0 is 64 bytes. Above that every power-of-two range [2^e, 2^(e+1)) is
+// split into four classes of 2^(e-2) bytes each: 80, 96, 112, 128, 160, …
+
+static constexpr size_t ALIGN          = 64;
+static constexpr size_t HUGE_PAGE      = size_t(2) << 20;   // 2 MiB
+static constexpr int    MAX_EXP        = 40;                // classes up to 1 TiB
+static constexpr int    NUM_CLASSES    = (MAX_EXP - 6) * 4 + 1;
+
+// Per-thread cache limits: only blocks below HUGE_PAGE, a few per class.
+static constexpr size_t THREAD_CLASS_BLOCKS = 8;
+static constexpr size_t THREAD_CACHE_BYTES  = size_t(16) << 20;
+
+static int sizeClass(size_t bytes) {
+    if (bytes <= ALIGN) return 0;
+    size_t n = bytes - 1;
+    int e = 63 - __builtin_clzll((unsigned long long)n);      // >= 6
+    int q = (int)((n >> (e - 2)) & 3);
+    return (e - 6) * 4 + q + 1;
+}
+
+static size_t classSize(int c) {
+    if (c == 0) return ALIGN;
+    int e = (c - 1) / 4 + 6, q = (c - 1) % 4;
+    return size_t(4 + q + 1) << (e - 2);
+}
+
+static bool isHuge(size_t classBytes) { return classBytes >= HUGE_PAGE; }
+
+// ── Counters ──────────────────────────────────────────────────────────────────
+
+namespace {
+struct Counters {
+    std::atomic<uint64_t> allocs{0}, frees{0}, threadHits{0}, poolHits{0};
+    std::atomic<uint64_t> systemAllocs{0}, hugeAllocs{0}, released{0};
+    std::atomic<size_t>   bytesLive{0}, bytesPeak{0}, bytesCached{0};
+};
+} // namespace
+
+extern "C" void nexa_alloc_stats();
+
+static Counters& counters() {
+    static Counters* c = [] {
+        // NEXA_ALLOC_STATS=1 prints the counters when the program exits
+        if (const char* env = std::getenv("NEXA_ALLOC_STATS"); env && *env && *env != '0')
+            std::atexit(nexa_alloc_stats);
+        return new Counters();             // leaked: outlives thread caches
+    }();
+    return *c;
+}
+
+static void noteLive(size_t bytes) {
+    auto& k = counters();
+    size_t live = k.bytesLive.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = k.bytesPeak.load(std::memory_order_relaxed);
+    while (live > peak && !k.bytesPeak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+// ── System allocation ─────────────────────────────────────────────────────────
+
+static void* systemAlloc(size_t bytes) {
+    auto& k = counters();
+    k.systemAllocs.fetch_add(1, std::memory_order_relaxed);
+#ifdef NEXA_HAVE_MMAP
+    if (isHuge(bytes)) {
+        // Over-map by one huge page and trim, so the block starts on a 2 MiB
+        // boundary and the kernel can back it with huge pages.
+        size_t span = bytes + HUGE_PAGE;
+        void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) throw std::bad_alloc();
+        uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t p    = (base + HUGE_PAGE - 1) & ~(uintptr_t)(HUGE_PAGE - 1);
+        if (p > base) munmap(raw, p - base);
+        size_t tail = (base + span) - (p + bytes);
+        if (tail) munmap(reinterpret_cast<void*>(p + bytes), tail);
+#ifdef MADV_HUGEPAGE
+        madvise(reinterpret_cast<void*>(p), bytes, MADV_HUGEPAGE);
+#endif
+        k.hugeAllocs.fetch_add(1, std::memory_order_relaxed);
+        return reinterpret_cast<void*>(p);
+    }
+#endif
+    void* p = std::aligned_alloc(ALIGN, bytes);     // class sizes are multiples of 64
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+static void systemFree(void* p, size_t bytes) {
+    counters().released.fetch_add(1, std::memory_order_relaxed);
+#ifdef NEXA_HAVE_MMAP
+    if (isHuge(bytes)) { munmap(p, bytes); return; }
+#endif
+    std::free(p);
+}
+
+// ── Shared pool ───────────────────────────────────────────────────────────────
+
+namespace {
+struct SharedPool {
+    std::mutex                      mutex;
+    std::vector<std::vector<void*>> lists = std::vector<std::vector<void*>>(NUM_CLASSES);
+    size_t                          cached = 0;
+    size_t                          limit;
+
+    SharedPool() {
+        size_t mb = 1024;
+        if (const char* env = std::getenv("NEXA_POOL_LIMIT_MB")) mb = (size_t)std::strtoull(env, nullptr, 10);
+        limit = mb << 20;
+    }
+
+    void* take(int c) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& l = lists[c];
+        if (l.empty()) return nullptr;
+        void* p = l.back();
+        l.pop_back();
+        cached -= classSize(c);
+        return p;
+    }
+
+    // Returns false when the pool is full; the caller frees the block.
+    bool put(int c, void* p) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cached + classSize(c) > limit) return false;
+        lists[c].push_back(p);
+        cached += classSize(c);
+        return true;
+    }
+
+    void trim() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int c = 0; c < NUM_CLASSES; ++c) {
+            for (void* p : lists[c]) {
+                systemFree(p, classSize(c));
+                counters().bytesCached.fetch_sub(classSize(c), std::memory_order_relaxed);
+            }
+            lists[c].clear();
+        }
+        cached = 0;
+    }
+};
+} // namespace
+
+static SharedPool& sharedPool() {
+    static SharedPool* pool = new SharedPool();   // leaked: outlives thread caches
+    return *pool;
+}
+
+static void releaseToPool(int c, void* p) {
+    if (!sharedPool().put(c, p)) {
+        counters().bytesCached.fetch_sub(classSize(c), std::memory_order_relaxed);
+        systemFree(p, classSize(c));
+    }
+}
+
+// ── Thread cache ──────────────────────────────────────────────────────────────
+
+// Set once this thread's cache is destroyed: buffers freed later in thread
+// exit (other thread_local caches holding tensors) go to the shared pool.
+static thread_local bool threadCacheGone = false;
+
+namespace {
+struct ThreadCache {
+    std::vector<std::vector<void*>> lists;
+    size_t                          cached = 0;
+
+    ~ThreadCache() {
+        flush();
+        threadCacheGone = true;
+    }
+
+    void flush() {
+        for (size_t c = 0; c < lists.size(); ++c) {
+            for (void* p : lists[c]) releaseToPool((int)c, p);
+            lists[c].clear();
+        }
+        cached = 0;
+    }
+
+    void* take(int c) {
+        if ((size_t)c >= lists.size() || lists[c].empty()) return nullptr;
+        void* p = lists[c].back();
+        lists[c].pop_back();
+        cached -= classSize(c);
+        return p;
+    }
+
+    bool put(int c, void* p) {
+        size_t sz = classSize(c);
+        if (isHuge(sz) || cached + sz > THREAD_CACHE_BYTES) return false;
+        if ((size_t)c >= lists.size()) lists.resize(c + 1);
+        if (lists[c].size() >= THREAD_CLASS_BLOCKS) return false;
+        lists[c].push_back(p);
+        cached += sz;
+        return true;
+    }
+};
+} // namespace
+
+static thread_local ThreadCache threadCache;
+
+// ── Public API ────────────────────────────────────────────────────────────────
+
+void* tensor_alloc(size_t bytes) {
+    auto& k = counters();
+    k.allocs.fetch_add(1, std::memory_order_relaxed);
+    int c = sizeClass(bytes);
+    if (c >= NUM_CLASSES) throw std::bad_alloc();
+    size_t sz = classSize(c);
+    noteLive(sz);
+
+    if (void* p = threadCacheGone ? nullptr : threadCache.take(c)) {
+        k.threadHits.fetch_add(1, std::memory_order_relaxed);
+        k.bytesCached.fetch_sub(sz, std::memory_order_relaxed);
+        return p;
+    }
+    if (void* p = sharedPool().take(c)) {
+        k.poolHits.fetch_add(1, std::memory_order_relaxed);
+        k.bytesCached.fetch_sub(sz, std::memory_order_relaxed);
+        return p;
+    }
+    return systemAlloc(sz);
+}
+
+void tensor_free(void* p, size_t bytes) {
+    if (!p) return;
+    auto& k = counters();
+    int    c  = sizeClass(bytes);
+    size_t sz = classSize(c);
+    k.frees.fetch_add(1, std::memory_order_relaxed);
+    k.bytesLive.fetch_sub(sz, std::memory_order_relaxed);
+    k.bytesCached.fetch_add(sz, std::memory_order_relaxed);
+    if (threadCacheGone || !threadCache.put(c, p)) releaseToPool(c, p);
+}
+
+void alloc_trim() {
+    if (!threadCacheGone) threadCache.flush();
+    sharedPool().trim();
+}
+
+AllocStats alloc_stats() {
+    auto& k = counters();
+    AllocStats s;
+    s.allocs       = k.allocs.load(std::memory_order_relaxed);
+    s.frees        = k.frees.load(std::memory_order_relaxed);
+    s.threadHits   = k.threadHits.load(std::memory_order_relaxed);
+    s.poolHits     = k.poolHits.load(std::memory_order_relaxed);
+    s.systemAllocs = k.systemAllocs.load(std::memory_order_relaxed);
+    s.hugeAllocs   = k.hugeAllocs.load(std::memory_order_relaxed);
+    s.released     = k.released.load(std::memory_order_relaxed);
+    s.bytesLive    = k.bytesLive.load(std::memory_order_relaxed);
+    s.bytesPeak    = k.bytesPeak.load(std::memory_order_relaxed);
+    s.bytesCached  = k.bytesCached.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace nexa
+
+extern "C" {
+
+void nexa_alloc_stats() {
+    auto s = nexa::alloc_stats();
+    std::fprintf(stderr,
+        "[nexa] tensor allocator: %llu allocs, %llu frees, hit rate %.1f%% "
+        "(%llu thread cache, %llu shared pool, %llu system, %llu huge-page)\n"
+        "[nexa]   live %.2f MiB, peak %.2f MiB, cached %.2f MiB, %llu blocks released\n",
+        (unsigned long long)s.allocs, (unsigned long long)s.frees, 100.0 * s.hitRate(),
+        (unsigned long long)s.threadHits, (unsigned long long)s.poolHits,
+        (unsigned long long)s.systemAllocs, (unsigned long long)s.hugeAllocs,
+        s.bytesLive / 1048576.0, s.bytesPeak / 1048576.0, s.bytesCached / 1048576.0,
+        (unsigned long long)s.released);
+}
+
+void nexa_alloc_trim() { nexa::alloc_trim(); }
+
+} // extern "C"
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace nexa {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Pooled allocator for tensor buffers.
+//
+// Requests are rounded up to a size class (four classes per power of two, so
+// at most 25% slack) and freed blocks are kept on per-class free lists instead
+// of going back to the system:
+//   • each thread has a small cache of recently freed blocks (no locking)
+//   • overflow and blocks freed by exiting threads go to a shared pool
+//   • buffers >= 2 MiB are mmap'ed on 2 MiB boundaries with transparent huge
+//     pages requested, and always live in the shared pool
+// All blocks are 64-byte aligned. NEXA_POOL_LIMIT_MB caps the bytes the
+// shared pool may hold (default 1024); beyond that blocks are released.
+// NEXA_ALLOC_STATS=1 prints the counters below at program exit.
+// ─────────────────────────────────────────────────────────────────────────────
+
+void* tensor_alloc(size_t bytes);
+void  tensor_free(void* p, size_t bytes);   // bytes must match the allocation
+
+// Return every cached block to the system.
+void  alloc_trim();
+
+struct AllocStats {
+    uint64_t allocs;          // tensor_alloc calls
+    uint64_t frees;           // tensor_free calls
+    uint64_t threadHits;      // served from the calling thread's cache
+    uint64_t poolHits;        // served from the shared pool
+    uint64_t systemAllocs;    // had to ask the system (malloc / mmap)
+    uint64_t hugeAllocs;      // of those, huge-page mappings
+    uint64_t released;        // blocks handed back to the system
+    size_t   bytesLive;       // size-class bytes currently handed out
+    size_t   bytesPeak;
+    size_t   bytesCached;     // bytes parked on free lists (all threads)
+    double   hitRate() const { return allocs ? double(threadHits + poolHits) / allocs : 0.0; }
+};
+AllocStats alloc_stats();
+
+// std::allocator replacement backed by the pool. Elements are default-
+// initialised, so FloatBuffer(n) / resize(n) leave floats uninitialised —
+// pass a fill value when zeros are needed.
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <typename U> PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(tensor_alloc(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept { tensor_free(p, n * sizeof(T)); }
+
+    template <typename U> void construct(U* p) noexcept { ::new (static_cast<void*>(p)) U; }
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+    template <typename U> bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    template <typename U> bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+};
+
+using FloatBuffer = std::vector<float, PoolAllocator<float>>;
+using ByteBuffer  = std::vector<uint8_t, PoolAllocator<uint8_t>>;   // reduced-precision storage
+
+} // namespace nexa
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LLVM Bridge
+// ─────────────────────────────────────────────────────────────────────────────
+extern "C" {
+
+void nexa_alloc_stats();    // print the counters to stderr
+void nexa_alloc_trim();
+
+} // extern "C"
@@ -0,0 +1,1187 @@
+#include "Tensor.h"
+#include "Parallel.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define NEXA_CSV_X86 1
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+// CSV reader.
+//
+// The file is mapped read-only and parsed where it lies: no line strings,
+// no token vectors, no per-cell allocation. It is cut into byte ranges of
+// about CSV_GRAIN, each moved forward to the next record start, and the
+// ranges are parsed by the thread pool. A quick pass counts each range's
+// newlines (32 bytes per step on AVX2) to bound its rows, so the tensor
+// buffer is allocated once, up front, and every range parses straight into
+// its own slot of it; the slots are then closed up with a prefix sum over
+// the real row counts. Line ends are found with memchr. Plain decimals are parsed by a short
+// digit loop and everything else by std::from_chars; both stop at the first
+// character that cannot continue the number, so the delimiter never has to
+// be searched for separately.
+//
+// Cells keep the meaning they had with the old getline / stof reader:
+//   • surrounding spaces, tabs and '\r' are ignored; a leading '+' is allowed
+//   • a cell that does not start with a number reads as 0; one that does
+//     reads as that number ("12abc" → 12)
+//   • blank lines are skipped, and with skip_header so is the first
+//     non-blank one
+//   • the first row fixes the column count: a trailing ',' adds no column;
+//     shorter rows are padded with 0 and longer ones cut
+//   • a quoted cell ("…") may hold ',' and newlines; it reads as the
+//     number at the start of its content, like any other cell
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace {
+
+constexpr int64_t CSV_GRAIN = 1 << 20;   // bytes per parallel chunk
+
+// A read-only private mapping of a whole file; empty for an empty file.
+struct MappedText {
+    const char* data = nullptr;
+    size_t      size = 0;
+    bool        ok   = false;
+
+    explicit MappedText(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            size = (size_t)st.st_size;
+            if (size == 0) {
+                ok = true;
+            } else {
+                void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    madvise(p, size, MADV_SEQUENTIAL);
+                    data = static_cast<const char*>(p);
+                    ok   = true;
+                }
+            }
+        }
+        ::close(fd);
+    }
+    ~MappedText() { if (data) munmap(const_cast<char*>(data), size); }
+    MappedText(const MappedText&) = delete;
+    MappedText& operator=(const MappedText&) = delete;
+};
+
+// ── Byte counts ───────────────────────────────────────────────────────────────
+
+size_t countByteGeneric(const char* p, size_t n, char c) {
+    return (size_t)std::count(p, p + n, c);
+}
+
+#ifdef NEXA_CSV_X86
+__attribute__((target("avx2,popcnt")))
+size_t countByteAvx2(const char* p, size_t n, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    size_t count = 0, i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        count += (size_t)_mm_popcnt_u32((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+    }
+    return count + countByteGeneric(p + i, n - i, c);
+}
+#endif
+
+// Occurrences of c in p[0, n).
+size_t countByte(const char* p, size_t n, char c) {
+    static const auto fn = [] {
+#ifdef NEXA_CSV_X86
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return countByteAvx2;
+#endif
+        return countByteGeneric;
+    }();
+    return fn(p, n, c);
+}
+
+// ── Records and cells ─────────────────────────────────────────────────────────
+// A record is a line, except that a quoted cell ("…", with "" for a literal
+// quote) may hold ',' and '\n'. Every '"' toggles between inside and outside
+// a quoted cell, so the state at any byte follows from the parity of the
+// quotes before it — that is what lets a chunk find its first record
+// without parsing the bytes before it.
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline const char* find(const char* p, const char* end, char c) {
+    auto* f = static_cast<const char*>(memchr(p, c, (size_t)(end - p)));
+    return f ? f : end;
+}
+
+// Just past the quote that closes a quoted cell whose content starts at p.
+inline const char* closingQuote(const char* p, const char* end) {
+    for (;;) {
+        const char* q = find(p, end, '"');
+        if (q + 1 < end && q[1] == '"') { p = q + 2; continue; }
+        return q < end ? q + 1 : end;
+    }
+}
+
+// The '\n' ending the record that starts at p (or end). quotes: whether the
+// file has any '"' at all; without them a record is just a line.
+inline const char* recordEnd(const char* p, const char* end, bool quotes) {
+    for (;;) {
+        const char* nl = find(p, end, '\n');
+        if (!quotes) return nl;
+        const char* q = find(p, nl, '"');
+        if (q == nl) return nl;
+        p = closingQuote(q + 1, end);
+    }
+}
+
+// Start of the first record that begins after b, where b lies inside a
+// quoted cell when inQuote is set.
+const char* nextRecord(const char* b, const char* end, bool inQuote) {
+    for (const char* p = b; p < end; ) {
+        const char* nl = find(p, end, '\n');
+        const char* q  = find(p, nl, '"');
+        if (q < nl) { inQuote = !inQuote; p = q + 1; continue; }
+        if (!inQuote) return nl < end ? nl + 1 : end;
+        p = nl + 1;
+    }
+    return end;
+}
+
+inline bool blankLine(const char* p, const char* e) {
+    while (p < e && isSpace(*p)) ++p;
+    return p == e;
+}
+
+// Columns of the first row: one per ',' outside quotes plus one, except
+// after a trailing ','.
+int64_t countColumns(const char* p, const char* e) {
+    int64_t n = 1;
+    for (bool inQuote = false; p < e; ++p) {
+        if (*p == '"') inQuote = !inQuote;
+        else if (*p == ',' && !inQuote) ++n;
+    }
+    return e[-1] == ',' ? n - 1 : n;
+}
+
+// Plain decimals ("-12.75") with a mantissa of at most 2^24 and at most 10
+// fraction digits: m and 10^k are both exact floats, so one IEEE division
+// rounds correctly. Anything else (exponents, long mantissas, inf / nan, hex)
+// returns false and goes to from_chars.
+inline bool parseSimple(const char*& p, const char* e, float& v) {
+    static constexpr float POW10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    const char* s = p;
+    bool neg = s < e && *s == '-';
+    s += neg;
+    uint64_t m = 0;
+    int digits = 0, frac = 0;
+    for (; s < e && (unsigned)(*s - '0') < 10 && digits < 19; ++s, ++digits) m = m * 10 + (unsigned)(*s - '0');
+    if (s < e && *s == '.') {
+        for (++s; s < e && (unsigned)(*s - '0') < 10 && digits < 19; ++s, ++digits, ++frac) m = m * 10 + (unsigned)(*s - '0');
+    }
+    if (digits == 0 || frac > 10 || m > (1u << 24)) return false;
+    if (s < e && ((unsigned)(*s - '0') < 10 || *s == '.' || *s == 'e' || *s == 'E' || *s == 'x' || *s == 'X'))
+        return false;
+    v = (float)m / POW10[frac];
+    if (neg) v = -v;
+    p = s;
+    return true;
+}
+
+// The number at s into v: the position just after it, or nullptr (and
+// v = 0) when s does not start with one.
+inline const char* parseNumber(const char* s, const char* e, float& v) {
+    if (s < e && *s == '+' && s + 1 < e && s[1] != '-') ++s;
+    if (parseSimple(s, e, v)) return s;
+    auto r = std::from_chars(s, e, v);
+    if (r.ec != std::errc()) { v = 0.f; return nullptr; }
+    // "0x1p3": from_chars stops after the "0"; stof read hex floats
+    bool neg = *s == '-';
+    if (r.ptr - s == 1 + neg && r.ptr < e && (*r.ptr == 'x' || *r.ptr == 'X')) {
+        auto h = std::from_chars(r.ptr + 1, e, v, std::chars_format::hex);
+        if (h.ec != std::errc()) { v = 0.f; return r.ptr; }
+        if (neg) v = -v;
+        return h.ptr;
+    }
+    return r.ptr;
+}
+
+// Parse the cell starting at p into v; returns the start of the next cell
+// (past the ','), or e at the end of the record.
+inline const char* parseCell(const char* p, const char* e, float& v) {
+    while (p < e && isSpace(*p)) ++p;
+    if (p < e && *p == '"') {                       // the number inside the quotes
+        const char* close = closingQuote(p + 1, e);
+        const char* ce = close > p + 1 && close[-1] == '"' ? close - 1 : close;
+        const char* s = p + 1;
+        while (s < ce && isSpace(*s)) ++s;
+        parseNumber(s, ce, v);
+        p = close;
+    } else if (const char* n = parseNumber(p, e, v)) {
+        if (n < e && *n == ',') return n + 1;
+        p = n;
+    }
+    while (p < e && *p != ',') ++p;      // trailing spaces or junk ("12abc")
+    return p < e ? p + 1 : e;
+}
+
+// One record into out[0, cols); missing cells are 0.
+inline void parseRecord(const char* p, const char* e, float* out, int64_t cols) {
+    int64_t j = 0;
+    for (; j < cols && p < e; ++j) p = parseCell(p, e, out[j]);
+    for (; j < cols; ++j) out[j] = 0.f;
+}
+
+// ── Column projection ─────────────────────────────────────────────────────────
+// read_csv / csv_open with a column list parse only those cells: the cells
+// in between are stepped over to the next ',' without being parsed, and
+// nothing after the last selected column is looked at.
+
+// Start of the cell after the one at p (past the ','), or e.
+inline const char* skipCell(const char* p, const char* e) {
+    while (p < e && isSpace(*p)) ++p;
+    if (p < e && *p == '"') p = closingQuote(p + 1, e);
+    p = find(p, e, ',');
+    return p < e ? p + 1 : e;
+}
+
+const char* skipCommasGeneric(const char* p, const char* e, int64_t k) {
+    for (; k > 0 && p < e; --k) {
+        p = find(p, e, ',');
+        if (p < e) ++p;
+    }
+    return p;
+}
+
+#ifdef NEXA_CSV_X86
+__attribute__((target("avx2,popcnt")))
+const char* skipCommasAvx2(const char* p, const char* e, int64_t k) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    while (k > 0 && e - p >= 32) {
+        __m256i  v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned m = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, comma));
+        int64_t  c = _mm_popcnt_u32(m);
+        if (c < k) { k -= c; p += 32; continue; }
+        for (; k > 1; --k) m &= m - 1;           // drop all but the k-th comma
+        return p + __builtin_ctz(m) + 1;
+    }
+    return skipCommasGeneric(p, e, k);
+}
+#endif
+
+// Past the k-th ',' in [p, e), or e: k cells of a record without quotes.
+const char* skipCommas(const char* p, const char* e, int64_t k) {
+    static const auto fn = [] {
+#ifdef NEXA_CSV_X86
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return skipCommasAvx2;
+#endif
+        return skipCommasGeneric;
+    }();
+    return fn(p, e, k);
+}
+
+// Output column k is file column sel[k]; columns may be listed in any order
+// and more than once.
+struct Projection {
+    std::vector<int64_t> file;       // distinct selected file columns, ascending
+    std::vector<int64_t> slot;       // output column that file[i] is parsed into
+    std::vector<std::pair<int64_t, int64_t>> copies;   // out[first] = out[second] for repeats
+    int64_t width = 0;               // output columns
+
+    // false (and a message) when sel is not a list of columns in [0, cols).
+    bool build(const std::vector<float>& sel, int64_t cols, const char* fn) {
+        width = (int64_t)sel.size();
+        std::vector<std::pair<int64_t, int64_t>> order;   // (file column, output column)
+        for (int64_t k = 0; k < width; ++k) {
+            float v = sel[(size_t)k];
+            if (!(v >= 0.f && v < (float)cols) || v != (float)(int64_t)v) {
+                fprintf(stderr, "[nexa] %s: %g is not a column index in [0, %lld)\n", fn, v, (long long)cols);
+                return false;
+            }
+            order.push_back({(int64_t)v, k});
+        }
+        std::sort(order.begin(), order.end());
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (i > 0 && order[i].first == order[i - 1].first) {
+                copies.push_back({order[i].second, slot.back()});
+                continue;
+            }
+            file.push_back(order[i].first);
+            slot.push_back(order[i].second);
+        }
+        return true;
+    }
+
+    // The selected cells of one record into out[0, width); missing cells are
+    // 0. Without quotes in the file a run of skipped cells is a run of ','.
+    void parse(const char* p, const char* e, float* out, bool quotes) const {
+        int64_t j = 0;
+        for (size_t i = 0; i < file.size(); ++i) {
+            if (!quotes && j < file[i]) {
+                p = skipCommas(p, e, file[i] - j);
+                j = file[i];
+            }
+            for (; j < file[i] && p < e; ++j) p = skipCell(p, e);
+            if (p < e) {
+                p = parseCell(p, e, out[slot[i]]);
+                ++j;
+            } else {
+                out[slot[i]] = 0.f;
+            }
+        }
+        for (auto& c : copies) out[c.first] = out[c.second];
+    }
+};
+
+// The elements of a column-list tensor, in order.
+std::vector<float> columnList(const nexa::Tensor& t) {
+    std::vector<float> v;
+    for (int64_t i = 0; i < t.rows; ++i)
+        for (int64_t j = 0; j < t.cols; ++j) v.push_back(t.get(i, j));
+    return v;
+}
+
+// Records starting in [p, stop) into out, cols floats each (proj->width with
+// a projection); returns the number of rows (blank lines are not rows).
+int64_t parseRecords(const char* p, const char* stop, const char* end, bool quotes, float* out, int64_t cols,
+                     const Projection* proj) {
+    int64_t rows = 0;
+    while (p < stop) {
+        const char* e = recordEnd(p, end, quotes);
+        if (!blankLine(p, e)) {
+            if (proj) proj->parse(p, e, out + rows++ * proj->width, quotes);
+            else      parseRecord(p, e, out + rows++ * cols, cols);
+        }
+        p = e < end ? e + 1 : end;
+    }
+    return rows;
+}
+
+// ── Reader ────────────────────────────────────────────────────────────────────
+
+// Record-aligned byte ranges of [first, end) for the thread pool, about
+// CSV_GRAIN each. Chunk k is [start[k], start[k + 1]); its rows go to
+// [bound[k], bound[k + 1]), sized by its newline count (an upper bound on
+// its rows), so every chunk can parse straight into its own slot.
+struct Chunks {
+    int                      count;
+    std::vector<const char*> start;
+    std::vector<int64_t>     bound;
+};
+
+Chunks splitChunks(const char* first, const char* end, bool quotes) {
+    // Raw boundaries are moved forward to a record start; quote parity at
+    // each one says whether it cuts a quoted cell.
+    int64_t n = end - first;
+    Chunks  c{std::max(nexa::parallel_chunks(n, CSV_GRAIN), 1), {}, {}};
+    c.start.resize(c.count + 1);
+    c.bound.assign(c.count + 1, 0);
+    std::vector<int64_t> quoteCount(c.count, 0);
+    auto rawStart = [&](int k) { return first + n * k / c.count; };
+    if (quotes)
+        nexa::parallel_for(c.count, 1, [&](int64_t b, int64_t e, int) {
+            for (int64_t k = b; k < e; ++k)
+                quoteCount[k] = (int64_t)countByte(rawStart((int)k), (size_t)(rawStart((int)k + 1) - rawStart((int)k)), '"');
+        });
+    c.start[0] = first;
+    c.start[c.count] = end;
+    int64_t quotesBefore = 0;
+    for (int k = 1; k < c.count; ++k) {
+        quotesBefore += quoteCount[k - 1];
+        c.start[k] = nextRecord(rawStart(k), end, quotesBefore % 2 != 0);
+    }
+    nexa::parallel_for(c.count, 1, [&](int64_t b, int64_t e, int) {
+        for (int64_t k = b; k < e; ++k)
+            c.bound[k + 1] = (int64_t)countByte(c.start[k], (size_t)(c.start[k + 1] - c.start[k]), '\n') + 1;
+    });
+    for (int k = 0; k < c.count; ++k) c.bound[k + 1] += c.bound[k];
+    return c;
+}
+
+// Close up the chunk slots of data (rows[k] rows of width floats each, in
+// order) and trim it; returns the total row count.
+int64_t closeUp(nexa::FloatBuffer& data, const Chunks& c, const std::vector<int64_t>& rows, int64_t width) {
+    int64_t total = 0;
+    for (int k = 0; k < c.count; ++k) {
+        if (total != c.bound[k])
+            std::memmove(data.data() + total * width, data.data() + c.bound[k] * width, (size_t)(rows[k] * width) * sizeof(float));
+        total += rows[k];
+    }
+    data.resize((size_t)(total * width));
+    return total;
+}
+
+// sel: the columns to keep, or nullptr for all of them.
+nexa::Tensor* readCsv(const MappedText& f, bool skipHeader, const std::vector<float>* sel) {
+    const char* p   = f.data;
+    const char* end = f.data + f.size;
+    bool quotes = f.size > 0 && memchr(p, '"', f.size) != nullptr;
+
+    // first data record: fixes the column count
+    const char* first = nullptr;
+    int64_t     cols  = 0;
+    for (bool header = skipHeader; p < end; ) {
+        const char* e = recordEnd(p, end, quotes);
+        if (!blankLine(p, e)) {
+            if (!header) { first = p; cols = countColumns(p, e); break; }
+            header = false;
+        }
+        p = e < end ? e + 1 : end;
+    }
+    if (!first) return new nexa::Tensor(nexa::FloatBuffer(), {0, 0});
+    Projection proj;
+    if (sel && !proj.build(*sel, cols, "read_csv")) return nullptr;
+    int64_t width = sel ? proj.width : cols;
+
+    Chunks c = splitChunks(first, end, quotes);
+    std::vector<int64_t> rows(c.count, 0);
+    nexa::FloatBuffer data((size_t)(c.bound[c.count] * width));
+    nexa::parallel_for(c.count, 1, [&](int64_t b, int64_t e, int) {
+        for (int64_t k = b; k < e; ++k)
+            rows[k] = parseRecords(c.start[k], c.start[k + 1], end, quotes, data.data() + c.bound[k] * width, cols,
+                                   sel ? &proj : nullptr);
+    });
+    int64_t total = closeUp(data, c, rows, width);
+    return new nexa::Tensor(std::move(data), {(int)total, (int)width});
+}
+
+// ── Typed tables ──────────────────────────────────────────────────────────────
+// read_table takes the first non-blank record as the header and fixes a
+// type for every column from the TABLE_SAMPLE_ROWS records after it (empty
+// and NA / null cells do not count):
+//   • number — every sample cell is a number; cells read as with read_csv,
+//              except that an empty or NA / null cell is NaN rather than 0
+//   • date   — every one is a date, YYYY-MM-DD or YYYY/MM/DD with an optional
+//              time ("T08:30", " 08:30:15.5", "Z"); read as days since
+//              1970-01-01, the time as a fraction of a day, and NaN for a
+//              cell that is not a date
+//   • text   — anything else: skipped, or with TEXT_CODES replaced by its
+//              code in the column's dictionary (0, 1, … in order of first
+//              appearance; -1 for an empty cell)
+// The types are decided once, so the parse is a switch per cell over that
+// plan with no fallbacks. Each chunk builds its own dictionaries, keyed by
+// the cell text where it lies in the mapping; they are merged in file order
+// and the chunk codes remapped, so codes do not depend on the thread count.
+
+constexpr int64_t TABLE_SAMPLE_ROWS = 1000;
+constexpr int     TEXT_SKIP = 0, TEXT_CODES = 1;
+
+enum class ColumnType { Number, Date, Text };
+
+// The content of the cell at p into v: trimmed, or inside the quotes for a
+// quoted cell. Returns the start of the next cell, like parseCell.
+inline const char* textCell(const char* p, const char* e, std::string_view& v) {
+    while (p < e && isSpace(*p)) ++p;
+    const char* s = p;
+    const char* ce;
+    if (p < e && *p == '"') {
+        const char* close = closingQuote(p + 1, e);
+        s  = p + 1;
+        ce = close > s && close[-1] == '"' ? close - 1 : close;
+        p  = find(close, e, ',');
+    } else {
+        p  = find(p, e, ',');
+        ce = p;
+        while (ce > s && isSpace(ce[-1])) --ce;
+    }
+    v = std::string_view(s, (size_t)(ce - s));
+    return p < e ? p + 1 : e;
+}
+
+inline std::string_view trimmed(std::string_view v) {
+    while (!v.empty() && isSpace(v.front())) v.remove_prefix(1);
+    while (!v.empty() && isSpace(v.back()))  v.remove_suffix(1);
+    return v;
+}
+
+// The text of a cell, with a quoted cell's "" unescaped.
+std::string unescaped(std::string_view v) {
+    std::string out(v);
+    for (size_t i = out.find("\"\""); i != std::string::npos; i = out.find("\"\"", i + 1)) out.erase(i, 1);
+    return out;
+}
+
+bool isMissing(std::string_view v) {
+    v = trimmed(v);
+    auto is = [&](const char* w) {
+        size_t n = strlen(w);
+        if (v.size() != n) return false;
+        for (size_t i = 0; i < n; ++i)
+            if ((v[i] | 0x20) != w[i]) return false;
+        return true;
+    };
+    return v.empty() || is("na") || is("n/a") || is("null") || is("none");
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date.
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t  era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+// A whole cell as a date (see above) into v; false when it is not one.
+bool parseDate(std::string_view cell, float& v) {
+    cell = trimmed(cell);
+    const char* s = cell.data();
+    const char* e = s + cell.size();
+    auto digits = [&](int n, int& out) {
+        if (e - s < n) return false;
+        out = 0;
+        for (int i = 0; i < n; ++i, ++s) {
+            if ((unsigned)(*s - '0') >= 10) return false;
+            out = out * 10 + (*s - '0');
+        }
+        return true;
+    };
+    auto skip = [&](char c) { return s < e && *s == c ? (++s, true) : false; };
+    int y, m, d, hh = 0, mm = 0, ss = 0;
+    if (!digits(4, y) || s == e || (*s != '-' && *s != '/')) return false;
+    char sep = *s++;
+    if (!digits(2, m) || !skip(sep) || !digits(2, d)) return false;
+    static constexpr int MONTH_DAYS[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (m < 1 || m > 12 || d < 1 || d > MONTH_DAYS[m - 1]) return false;
+    if (m == 2 && d == 29 && (y % 4 != 0 || (y % 100 == 0 && y % 400 != 0))) return false;
+    double frac = 0.0;
+    if (skip('T') || skip(' ')) {
+        if (!digits(2, hh) || !skip(':') || !digits(2, mm)) return false;
+        double sec = 0.0;
+        if (skip(':')) {
+            if (!digits(2, ss)) return false;
+            sec = ss;
+            if (skip('.')) {
+                for (double unit = 0.1; s < e && (unsigned)(*s - '0') < 10; ++s, unit /= 10) sec += (*s - '0') * unit;
+            }
+        }
+        skip('Z');
+        if (hh > 23 || mm > 59 || sec >= 61) return false;
+        frac = (hh * 3600 + mm * 60 + sec) / 86400.0;
+    }
+    if (s != e) return false;
+    v = (float)((double)daysFromCivil(y, (unsigned)m, (unsigned)d) + frac);
+    return true;
+}
+
+ColumnType cellType(std::string_view cell) {
+    std::string_view t = trimmed(cell);
+    float v;
+    if (parseNumber(t.data(), t.data() + t.size(), v) == t.data() + t.size()) return ColumnType::Number;
+    return parseDate(t, v) ? ColumnType::Date : ColumnType::Text;
+}
+
+// One column of the file: how its cells are read and which output column
+// they go to (-1: skipped).
+struct TableColumn {
+    ColumnType type;
+    int64_t    out;
+};
+
+// Codes of one text column, within one chunk.
+struct Dictionary {
+    std::unordered_map<std::string_view, int32_t> codes;
+    std::vector<std::string_view>                 order;
+
+    float code(std::string_view v) {
+        auto r = codes.try_emplace(v, (int32_t)order.size());
+        if (r.second) order.push_back(v);
+        return (float)r.first->second;
+    }
+};
+
+// Records starting in [p, stop) into out per plan (width floats a row);
+// dicts has one entry per output column. Returns the number of rows.
+int64_t parseTable(const char* p, const char* stop, const char* end, bool quotes,
+                   const std::vector<TableColumn>& plan, int64_t width, float* out, std::vector<Dictionary>& dicts) {
+    int64_t rows = 0;
+    for (; p < stop; ) {
+        const char* e = recordEnd(p, end, quotes);
+        if (!blankLine(p, e)) {
+            float* row = out + rows++ * width;
+            const char* q = p;
+            for (const TableColumn& c : plan) {
+                if (c.out < 0) { q = skipCell(q, e); continue; }
+                float& v = row[c.out];
+                std::string_view t;
+                switch (c.type) {
+                case ColumnType::Number: {
+                    const char* cell = q;
+                    if (q < e) q = parseCell(q, e, v);
+                    else       v = 0.f;
+                    if (v == 0.f) {                 // a zero, or no number at all
+                        textCell(cell, e, t);
+                        if (isMissing(t)) v = NAN;
+                    }
+                    break;
+                }
+                case ColumnType::Date:
+                    q = textCell(q, e, t);
+                    if (!parseDate(t, v)) v = NAN;
+                    break;
+                case ColumnType::Text:
+                    q = textCell(q, e, t);
+                    v = isMissing(t) ? -1.f : dicts[c.out].code(t);
+                    break;
+                }
+            }
+        }
+        p = e < end ? e + 1 : end;
+    }
+    return rows;
+}
+
+struct CsvTable {
+    nexa::ObjectHeader obj{[](void* p) { delete static_cast<CsvTable*>(p); }};   // must stay first
+    nexa::Tensor                          data;      // [rows x kept columns]
+    std::vector<std::string>              names;     // of data's columns
+    std::vector<ColumnType>               types;
+    std::vector<std::vector<std::string>> labels;    // dictionary of each coded text column
+
+    int64_t column(const char* name) const {
+        for (size_t j = 0; j < names.size(); ++j)
+            if (names[j] == name) return (int64_t)j;
+        return -1;
+    }
+};
+
+CsvTable* readTable(const MappedText& f, int textMode) {
+    auto*       table = new CsvTable();
+    const char* p     = f.data;
+    const char* end   = f.data + f.size;
+    bool quotes = f.size > 0 && memchr(p, '"', f.size) != nullptr;
+    auto next = [&](const char*& b, const char*& e) {     // the next non-blank record
+        for (; p < end; p = e < end ? e + 1 : end) {
+            b = p;
+            e = recordEnd(p, end, quotes);
+            if (!blankLine(b, e)) { p = e < end ? e + 1 : end; return true; }
+        }
+        return false;
+    };
+
+    // header, then the sample that fixes the column types
+    const char *b, *e;
+    if (!next(b, e)) return table;
+    std::vector<std::string> header;
+    for (const char* q = b; q < e; ) {
+        std::string_view t;
+        q = textCell(q, e, t);
+        header.push_back(unescaped(t));
+    }
+    if (e > b && e[-1] == ',') header.pop_back();        // a trailing ',' adds no column, as in read_csv
+    const char* first = p;
+    std::vector<bool> number(header.size(), false), date(header.size(), false), text(header.size(), false);
+    for (int64_t r = 0; r < TABLE_SAMPLE_ROWS && next(b, e); ++r) {
+        const char* q = b;
+        for (size_t j = 0; j < header.size() && q < e; ++j) {
+            std::string_view t;
+            q = textCell(q, e, t);
+            if (isMissing(t)) continue;
+            switch (cellType(t)) {
+            case ColumnType::Number: number[j] = true; break;
+            case ColumnType::Date:   date[j]   = true; break;
+            case ColumnType::Text:   text[j]   = true; break;
+            }
+        }
+    }
+    std::vector<TableColumn> plan;
+    for (size_t j = 0; j < header.size(); ++j) {
+        ColumnType type = text[j] || (date[j] && number[j]) ? ColumnType::Text
+                        : date[j]                           ? ColumnType::Date
+                                                            : ColumnType::Number;
+        bool keep = type != ColumnType::Text || textMode == TEXT_CODES;
+        plan.push_back({type, keep ? (int64_t)table->names.size() : -1});
+        if (!keep) continue;
+        table->names.push_back(header[j]);
+        table->types.push_back(type);
+    }
+    while (!plan.empty() && plan.back().out < 0) plan.pop_back();   // nothing after the last kept column is read
+    int64_t width = (int64_t)table->names.size();
+    table->labels.resize((size_t)width);
+
+    // parse, each chunk with its own dictionaries
+    Chunks c = first < end ? splitChunks(first, end, quotes) : Chunks{1, {end, end}, {0, 0}};
+    std::vector<int64_t> rows(c.count, 0);
+    std::vector<std::vector<Dictionary>> dicts(c.count, std::vector<Dictionary>((size_t)width));
+    nexa::FloatBuffer data((size_t)(c.bound[c.count] * width));
+    nexa::parallel_for(c.count, 1, [&](int64_t lo, int64_t hi, int) {
+        for (int64_t k = lo; k < hi; ++k)
+            rows[k] = parseTable(c.start[k], c.start[k + 1], end, quotes, plan, width, data.data() + c.bound[k] * width, dicts[k]);
+    });
+
+    // merge the dictionaries in chunk order and move chunk codes onto them
+    for (int64_t j = 0; j < width; ++j) {
+        if (table->types[j] != ColumnType::Text) continue;
+        std::unordered_map<std::string_view, int32_t> codes;
+        std::vector<std::vector<float>> remap(c.count);
+        for (int k = 0; k < c.count; ++k)
+            for (std::string_view v : dicts[k][j].order) {
+                auto r = codes.try_emplace(v, (int32_t)table->labels[j].size());
+                if (r.second) table->labels[j].push_back(unescaped(v));
+                remap[k].push_back((float)r.first->second);
+            }
+        if (c.count == 1) continue;                        // codes are already final
+        nexa::parallel_for(c.count, 1, [&](int64_t lo, int64_t hi, int) {
+            for (int64_t k = lo; k < hi; ++k) {
+                float* col = data.data() + c.bound[k] * width + j;
+                for (int64_t r = 0; r < rows[k]; ++r)
+                    if (col[r * width] >= 0.f) col[r * width] = remap[k][(size_t)col[r * width]];
+            }
+        });
+    }
+    int64_t total = closeUp(data, c, rows, width);
+    table->data = nexa::Tensor(std::move(data), {(int)total, (int)width});
+    return table;
+}
+
+// ── Streaming cursor ──────────────────────────────────────────────────────────
+// csv_open / csv_next_batch read a file of any size in constant memory. The
+// text goes through one read() buffer of CSV_READ_BLOCK bytes (grown only
+// for a single record longer than that): records are parsed out of it in
+// order and the unparsed tail is moved to the front before the next read.
+// Batches are parsed into buffers the cursor recycles — one whose last batch
+// tensor is gone is reused — so a loop that rebinds its batch variable
+// alternates between two buffers however long the file is. Records read
+// exactly as they do with read_csv.
+
+constexpr size_t CSV_READ_BLOCK    = (size_t)4 << 20;   // bytes per read()
+constexpr size_t CSV_BATCH_BUFFERS = 2;                 // recycled batch buffers per cursor
+
+struct CsvCursor {
+    nexa::ObjectHeader obj{[](void* p) { delete static_cast<CsvCursor*>(p); }};   // must stay first
+    int               fd = -1;
+    std::vector<char> text;                   // text[pos, len) is read but not parsed yet
+    size_t            pos = 0, len = 0;
+    bool              eof = false;
+    bool              quotes = false;         // a '"' has been read: records need the quote-aware scan
+    bool              header;                 // a header line is still to be skipped
+    int64_t           cols = -1;              // fixed by the first data record
+    bool              project;                // keep only the columns in select
+    std::vector<float> select;
+    Projection        proj;                   // built from select once cols is known
+    std::vector<std::shared_ptr<nexa::FloatBuffer>> batches;
+
+    CsvCursor(int f, bool skipHeader, const nexa::Tensor* sel)
+        : fd(f), text(CSV_READ_BLOCK), header(skipHeader), project(sel != nullptr) {
+        if (sel) select = columnList(*sel);
+    }
+    ~CsvCursor() { close(); }
+
+    void close() {
+        if (fd >= 0) ::close(fd);
+        fd  = -1;
+        eof = true;
+        pos = len = 0;
+        std::vector<char>().swap(text);
+        batches.clear();
+    }
+
+    // Move the unparsed tail to the front and read more after it.
+    void refill() {
+        std::memmove(text.data(), text.data() + pos, len - pos);
+        len -= pos;
+        pos  = 0;
+        if (len == text.size()) text.resize(text.size() * 2);
+        ssize_t r;
+        do r = ::read(fd, text.data() + len, text.size() - len);
+        while (r < 0 && errno == EINTR);
+        if (r < 0) fprintf(stderr, "[nexa] csv_next_batch: read failed: %s\n", strerror(errno));
+        if (r <= 0) { eof = true; return; }
+        quotes = quotes || memchr(text.data() + len, '"', (size_t)r) != nullptr;
+        len += (size_t)r;
+    }
+
+    // The next record as [b, e), consumed; false at the end of the file.
+    bool next(const char*& b, const char*& e) {
+        for (;;) {
+            const char* p   = text.data() + pos;
+            const char* end = text.data() + len;
+            if (p < end) {
+                const char* r = recordEnd(p, end, quotes);
+                if (r < end || eof) {             // complete: ends in '\n' or at the end of the file
+                    b   = p;
+                    e   = r;
+                    pos = (size_t)((r < end ? r + 1 : end) - text.data());
+                    return true;
+                }
+            } else if (eof) {
+                return false;
+            }
+            refill();
+        }
+    }
+
+    // A buffer of n floats no live batch uses.
+    std::shared_ptr<nexa::FloatBuffer> batchBuffer(size_t n) {
+        for (auto& b : batches)
+            if (b.use_count() == 1) { b->resize(n); return b; }
+        auto b = std::make_shared<nexa::FloatBuffer>(n);
+        if (batches.size() < CSV_BATCH_BUFFERS) batches.push_back(b);
+        return b;
+    }
+
+    nexa::Tensor* nextBatch(int64_t n) {
+        const char *b, *e;
+        while (cols < 0) {                        // first data record: fixes the column count
+            if (!next(b, e)) { cols = 0; break; }
+            if (blankLine(b, e)) continue;
+            if (header) { header = false; continue; }
+            cols = countColumns(b, e);
+            pos  = (size_t)(b - text.data());     // still to be parsed as the first row
+            if (project && !proj.build(select, cols, "csv_next_batch")) {
+                close();
+                return nullptr;
+            }
+        }
+        if (cols == 0) return new nexa::Tensor(nexa::FloatBuffer(), {0, 0});
+
+        int64_t width = project ? proj.width : cols;
+        auto    buf   = batchBuffer((size_t)(n * width));
+        int64_t rows  = 0;
+        while (rows < n && next(b, e)) {
+            if (blankLine(b, e)) continue;
+            float* out = buf->data() + rows++ * width;
+            if (project) proj.parse(b, e, out, quotes);
+            else         parseRecord(b, e, out, cols);
+        }
+        return new nexa::Tensor(std::move(buf), {(int)rows, (int)width});
+    }
+};
+
+// columns: a tensor listing the file columns to keep, or nullptr for all.
+void* openCursor(const char* path, int skip_header, const nexa::Tensor* columns) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[nexa] cannot open CSV '%s'\n", path);
+        return nullptr;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return new CsvCursor(fd, skip_header != 0, columns);
+}
+
+// ── Sidecar cache ─────────────────────────────────────────────────────────────
+// With NEXA_CSV_CACHE=1 in the environment, read_csv saves what it parsed
+// next to the file (data.csv → data.csv.nxcache), column by column, and
+// later reads of the same file map the sidecar instead of parsing. The
+// sidecar records the size and modification time of the CSV file and the
+// skip_header flag it was read with; when any of them changes it is stale
+// and the next read rebuilds it. A mapped sidecar comes back as a
+// column-major tensor (what transpose() of a row-major one looks like) whose
+// pages are read on first touch; as with load_tensor, writes into it stay
+// private. Reads with a column list use a valid sidecar (a column is one
+// contiguous run) but never write one. The sidecar is written to a
+// temporary name and renamed into place, so concurrent readers only ever
+// see a complete one.
+
+constexpr char     CACHE_MAGIC[8] = {'N', 'E', 'X', 'A', 'C', 'S', 'V', 'C'};
+constexpr uint32_t CACHE_VERSION  = 1;
+constexpr uint64_t CACHE_DATA     = 64;   // data offset: header, padded
+
+struct CacheHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t skipHeader;
+    int64_t  sourceSize;
+    int64_t  sourceMtime;                 // ns since the epoch
+    int64_t  rows, cols;                  // cols columns of rows floats each
+};
+static_assert(sizeof(CacheHeader) <= CACHE_DATA, "csv cache header");
+
+struct SourceKey {
+    int64_t size, mtime;
+};
+
+bool cacheEnabled() {
+    const char* v = getenv("NEXA_CSV_CACHE");
+    return v && *v && strcmp(v, "0") != 0;
+}
+
+bool sourceKey(const char* path, SourceKey& key) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    key = {(int64_t)st.st_size, (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec};
+    return true;
+}
+
+std::string cachePath(const char* path) { return std::string(path) + ".nxcache"; }
+
+// The mapped sidecar of path as a [rows x cols] column-major tensor, or
+// nullptr when there is none or it does not match key / skipHeader.
+nexa::Tensor* loadCache(const char* path, const SourceKey& key, bool skipHeader) {
+    int fd = ::open(cachePath(path).c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    CacheHeader h;
+    bool ok = fstat(fd, &st) == 0 && ::pread(fd, &h, sizeof h, 0) == (ssize_t)sizeof h &&
+              std::memcmp(h.magic, CACHE_MAGIC, sizeof CACHE_MAGIC) == 0 && h.version == CACHE_VERSION &&
+              h.skipHeader == (uint32_t)skipHeader && h.sourceSize == key.size && h.sourceMtime == key.mtime &&
+              h.rows > 0 && h.cols > 0 && h.rows <= INT32_MAX && h.cols <= INT32_MAX &&
+              (uint64_t)st.st_size >= CACHE_DATA + (uint64_t)(h.rows * h.cols) * sizeof(float);
+    size_t size = (size_t)st.st_size;
+    void*  map  = ok ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (map == MAP_FAILED) return nullptr;
+    auto* base = static_cast<uint8_t*>(map);
+    std::shared_ptr<uint8_t> file(base, [size](uint8_t* p) { munmap(p, size); });
+    nexa::Tensor columns(nexa::DType::F32, std::shared_ptr<uint8_t>(file, base + CACHE_DATA), {(int)h.cols, (int)h.rows});
+    return new nexa::Tensor(columns, 0, {(int)h.rows, (int)h.cols}, {1, h.rows});
+}
+
+// Write t (row-major, as read_csv returns it) as the sidecar of path.
+void saveCache(const char* path, const SourceKey& key, bool skipHeader, const nexa::Tensor& t) {
+    std::string final = cachePath(path), tmp = final + ".tmp" + std::to_string(getpid());
+    int64_t rows = t.rows, cols = t.cols;
+    size_t  size = CACHE_DATA + (size_t)(rows * cols) * sizeof(float);
+    int     fd   = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    void*   map  = fd >= 0 && ftruncate(fd, (off_t)size) == 0
+                 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[nexa] csv cache: cannot write '%s': %s\n", tmp.c_str(), strerror(errno));
+        if (fd >= 0) { ::close(fd); unlink(tmp.c_str()); }
+        return;
+    }
+    CacheHeader h;
+    std::memcpy(h.magic, CACHE_MAGIC, sizeof CACHE_MAGIC);
+    h.version     = CACHE_VERSION;
+    h.skipHeader  = skipHeader;
+    h.sourceSize  = key.size;
+    h.sourceMtime = key.mtime;
+    h.rows        = rows;
+    h.cols        = cols;
+    std::memcpy(map, &h, sizeof h);
+
+    // blocked transpose, a range of rows per thread
+    constexpr int64_t BLOCK = 64;
+    const float* src = t.elems;
+    float*       dst = reinterpret_cast<float*>(static_cast<uint8_t*>(map) + CACHE_DATA);
+    nexa::parallel_for((rows + BLOCK - 1) / BLOCK, 16, [&](int64_t b, int64_t e, int) {
+        for (int64_t i0 = b * BLOCK; i0 < std::min(rows, e * BLOCK); i0 += BLOCK)
+            for (int64_t j0 = 0; j0 < cols; j0 += BLOCK)
+                for (int64_t i = i0; i < std::min(rows, i0 + BLOCK); ++i)
+                    for (int64_t j = j0; j < std::min(cols, j0 + BLOCK); ++j) dst[j * rows + i] = src[i * cols + j];
+    });
+    munmap(map, size);
+    if (::close(fd) != 0 || rename(tmp.c_str(), final.c_str()) != 0) {
+        fprintf(stderr, "[nexa] csv cache: cannot write '%s': %s\n", final.c_str(), strerror(errno));
+        unlink(tmp.c_str());
+    }
+}
+
+// Columns sel of a mapped sidecar as a dense [rows x sel] tensor.
+nexa::Tensor* projectCache(const nexa::Tensor& c, const std::vector<float>& sel) {
+    Projection proj;
+    if (!proj.build(sel, c.cols, "read_csv")) return nullptr;
+    int64_t rows = c.rows, width = proj.width;
+    nexa::FloatBuffer data((size_t)(rows * width));
+    nexa::parallel_for(rows, 4096, [&](int64_t b, int64_t e, int) {
+        for (int64_t k = 0; k < width; ++k) {
+            const float* col = c.elems + (int64_t)sel[(size_t)k] * c.colStride;
+            for (int64_t i = b; i < e; ++i) data[(size_t)(i * width + k)] = col[i];
+        }
+    });
+    return new nexa::Tensor(std::move(data), {(int)rows, (int)width});
+}
+
+// ── Writer ────────────────────────────────────────────────────────────────────
+// Rows are formatted with std::to_chars straight into a byte buffer, a block
+// of about CSV_WRITE_BLOCK bytes at a time, and each buffer goes out in one
+// write(). Blocks are formatted by the thread pool a round at a time (one
+// block per thread) and written in order, so memory stays at a few blocks
+// whatever the tensor size. digits == 0 writes the shortest text that reads
+// back as the same float; 1…9 writes that many significant digits (%g
+// style), which is shorter but rounds.
+
+constexpr int64_t CSV_WRITE_BLOCK = 1 << 20;   // formatted bytes per block, about
+constexpr int64_t CSV_CELL_MAX    = 16;        // "-1.23456789e-38" and its ','
+
+bool writeAll(int fd, const char* p, size_t n) {
+    while (n > 0) {
+        ssize_t w = ::write(fd, p, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+// Rows [r0, r1) of t as CSV text into out (resized to fit).
+void formatRows(const nexa::Tensor& t, int64_t r0, int64_t r1, int digits, std::vector<char>& out) {
+    int64_t cols = t.cols;
+    out.resize((size_t)((r1 - r0) * (cols * CSV_CELL_MAX + 1)));
+    char* p = out.data();
+    for (int64_t i = r0; i < r1; ++i) {
+        for (int64_t j = 0; j < cols; ++j) {
+            float v = t.elems ? t.at(i, j) : t.get(i, j);
+            char* e = p + CSV_CELL_MAX - 1;
+            p = digits ? std::to_chars(p, e, v, std::chars_format::general, digits).ptr
+                       : std::to_chars(p, e, v).ptr;
+            *p++ = j + 1 < cols ? ',' : '\n';
+        }
+        if (cols == 0) *p++ = '\n';
+    }
+    out.resize((size_t)(p - out.data()));
+}
+
+bool writeCsv(int fd, const nexa::Tensor& t, int digits) {
+    int64_t rows      = t.rows;
+    int64_t blockRows = std::max<int64_t>(1, CSV_WRITE_BLOCK / (std::max<int64_t>(t.cols, 1) * CSV_CELL_MAX));
+    int64_t blocks    = (rows + blockRows - 1) / blockRows;
+    int64_t perRound  = std::max(nexa::parallel_chunks(blocks, 1), 1);
+    std::vector<std::vector<char>> text((size_t)std::min(perRound, std::max<int64_t>(blocks, 1)));
+    for (int64_t b0 = 0; b0 < blocks; b0 += perRound) {
+        int64_t n = std::min(perRound, blocks - b0);
+        nexa::parallel_for(n, 1, [&](int64_t b, int64_t e, int) {
+            for (int64_t k = b; k < e; ++k) {
+                int64_t r0 = (b0 + k) * blockRows;
+                formatRows(t, r0, std::min(rows, r0 + blockRows), digits, text[(size_t)k]);
+            }
+        });
+        for (int64_t k = 0; k < n; ++k)
+            if (!writeAll(fd, text[(size_t)k].data(), text[(size_t)k].size())) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LLVM Bridge
+// ─────────────────────────────────────────────────────────────────────────────
+extern "C" {
+
+void* csv_read(const char* path, int skip_header) {
+    SourceKey key;
+    bool cache = cacheEnabled() && sourceKey(path, key);
+    if (cache)
+        if (nexa::Tensor* t = loadCache(path, key, skip_header != 0)) return t;
+    MappedText f(path);
+    if (!f.ok) {
+        fprintf(stderr, "[nexa] cannot open CSV '%s'\n", path);
+        return nullptr;
+    }
+    nexa::Tensor* t = readCsv(f, skip_header != 0, nullptr);
+    if (cache && t->rows > 0 && t->cols > 0) saveCache(path, key, skip_header != 0, *t);
+    return t;
+}
+
+void* csv_read_cols(const char* path, int skip_header, void* columns) {
+    auto* c = nexa::tensorArg(columns);
+    if (!c) return nullptr;
+    std::vector<float> sel = columnList(*c);
+    SourceKey key;
+    if (cacheEnabled() && sourceKey(path, key))
+        if (nexa::Tensor* t = loadCache(path, key, skip_header != 0)) {
+            nexa::Tensor* r = projectCache(*t, sel);
+            ai_release(t);
+            return r;
+        }
+    MappedText f(path);
+    if (!f.ok) {
+        fprintf(stderr, "[nexa] cannot open CSV '%s'\n", path);
+        return nullptr;
+    }
+    return readCsv(f, skip_header != 0, &sel);
+}
+
+void csv_write(const char* path, void* tp) {
+    csv_write_digits(path, tp, 0);
+}
+
+void csv_write_digits(const char* path, void* tp, int digits) {
+    auto* t = nexa::tensorArg(tp);
+    if (!t) return;
+    if (digits < 0) {
+        fprintf(stderr, "[nexa] write_csv: digits must be >= 0, got %d\n", digits);
+        return;
+    }
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "[nexa] cannot write CSV '%s': %s\n", path, strerror(errno));
+        return;
+    }
+    bool ok = writeCsv(fd, *t, std::min(digits, 9));
+    if (::close(fd) != 0) ok = false;
+    if (!ok) fprintf(stderr, "[nexa] write_csv: write to '%s' failed: %s\n", path, strerror(errno));
+}
+
+void* csv_read_table(const char* path, int text_mode) {
+    if (text_mode != TEXT_SKIP && text_mode != TEXT_CODES) {
+        fprintf(stderr, "[nexa] read_table: text_mode must be 0 (skip) or 1 (codes), got %d\n", text_mode);
+        return nullptr;
+    }
+    MappedText f(path);
+    if (!f.ok) {
+        fprintf(stderr, "[nexa] cannot open CSV '%s'\n", path);
+        return nullptr;
+    }
+    return readTable(f, text_mode);
+}
+
+void* table_data(void* tp) {
+    const nexa::Tensor& d = static_cast<CsvTable*>(tp)->data;
+    return new nexa::Tensor(d, d.offset, d.shape, d.strides);
+}
+
+int table_index(void* tp, const char* name) {
+    return (int)static_cast<CsvTable*>(tp)->column(name);
+}
+
+void* table_col(void* tp, const char* name) {
+    auto*   t = static_cast<CsvTable*>(tp);
+    int64_t j = t->column(name);
+    if (j < 0) {
+        fprintf(stderr, "[nexa] table_col: no column '%s'\n", name);
+        return nullptr;
+    }
+    return csv_get_col(&t->data, (int)j);
+}
+
+const char* table_label(void* tp, const char* name, int code) {
+    auto*   t = static_cast<CsvTable*>(tp);
+    int64_t j = t->column(name);
+    if (j < 0 || code < 0 || (size_t)code >= t->labels[j].size()) return "";
+    return t->labels[j][(size_t)code].c_str();
+}
+
+void* csv_open(const char* path, int skip_header) {
+    return openCursor(path, skip_header, nullptr);
+}
+
+void* csv_open_cols(const char* path, int skip_header, void* columns) {
+    auto* c = nexa::tensorArg(columns);
+    return c ? openCursor(path, skip_header, c) : nullptr;
+}
+
+void* csv_next_batch(void* cursor, int n) {
+    if (!cursor) {
+        fprintf(stderr, "[nexa] csv_next_batch: no open file\n");
+        return nullptr;
+    }
+    if (n <= 0) {
+        fprintf(stderr, "[nexa] csv_next_batch: batch size must be positive, got %d\n", n);
+        return nullptr;
+    }
+    return static_cast<CsvCursor*>(cursor)->nextBatch(n);
+}
+
+void csv_close(void* cursor) {
+    if (!cursor) return;                    // csv_open already reported why
+    static_cast<CsvCursor*>(cursor)->close();
+}
+
+} // extern "C"
@@ -0,0 +1,225 @@
+#include "DType.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define NEXA_DTYPE_X86 1
+#endif
+
+namespace nexa {
+
+size_t dtypeSize(DType t) {
+    switch (t) {
+    case DType::F32:  return 4;
+    case DType::BF16: return 2;
+    case DType::F16:  return 2;
+    case DType::I8:   return 1;
+    }
+    return 4;
+}
+
+const char* dtypeName(DType t) {
+    switch (t) {
+    case DType::F32:  return "f32";
+    case DType::BF16: return "bf16";
+    case DType::F16:  return "f16";
+    case DType::I8:   return "i8";
+    }
+    return "?";
+}
+
+QuantParams chooseQuantParams(float lo, float hi) {
+    lo = std::min(lo, 0.f);
+    hi = std::max(hi, 0.f);
+    QuantParams q;
+    q.scale = hi > lo ? (hi - lo) / 255.f : 1.f;
+    q.zeroPoint = (int32_t)std::lround(-128.f - lo / q.scale);
+    q.zeroPoint = std::clamp(q.zeroPoint, -128, 127);
+    return q;
+}
+
+// ── Scalar conversions ────────────────────────────────────────────────────────
+
+static inline uint32_t bitsOf(float f) { uint32_t u; std::memcpy(&u, &f, 4); return u; }
+static inline float    fromBits(uint32_t u) { float f; std::memcpy(&f, &u, 4); return f; }
+
+static inline uint16_t toBf16(float f) {
+    uint32_t u = bitsOf(f);
+    if ((u & 0x7FFFFFFFu) > 0x7F800000u) return (uint16_t)((u >> 16) | 0x40);   // quiet NaN
+    u += 0x7FFFu + ((u >> 16) & 1);
+    return (uint16_t)(u >> 16);
+}
+static inline float fromBf16(uint16_t h) { return fromBits((uint32_t)h << 16); }
+
+static inline uint16_t toF16(float f) {
+    uint32_t x = bitsOf(f);
+    uint16_t sign = (uint16_t)((x >> 16) & 0x8000);
+    x &= 0x7FFFFFFFu;
+    if (x >= 0x7F800000u) return sign | 0x7C00 | (x > 0x7F800000u ? 0x200 : 0);   // inf / NaN
+    if (x >= 0x477FF000u) return sign | 0x7C00;                                  // rounds past 65504
+    if (x < 0x38800000u)                                                         // half subnormal
+        return sign | (uint16_t)std::nearbyint(fromBits(x) * 16777216.f);
+    x += 0xC8000FFFu + ((x >> 13) & 1);                 // rebias exponent, round to nearest even
+    return sign | (uint16_t)(x >> 13);
+}
+static inline float fromF16(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exp  = (h >> 10) & 0x1F, mant = h & 0x3FF;
+    if (exp == 0) {                                     // zero / subnormal: mant * 2^-24
+        float v = (float)mant * (1.f / 16777216.f);
+        return sign ? -v : v;
+    }
+    if (exp == 31) return fromBits(sign | 0x7F800000u | (mant << 13));
+    return fromBits(sign | ((exp + 112) << 23) | (mant << 13));
+}
+
+static inline int8_t toI8(float f, float inv, int32_t zp) {
+    float q = std::nearbyint(f * inv) + (float)zp;
+    return (int8_t)std::clamp(q, -128.f, 127.f);
+}
+
+// ── Vector kernels ────────────────────────────────────────────────────────────
+
+#ifdef NEXA_DTYPE_X86
+__attribute__((target("avx,f16c")))
+static void encodeF16C(const float* src, int64_t n, uint16_t* dst) {
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+    for (; i < n; ++i) dst[i] = toF16(src[i]);
+}
+
+__attribute__((target("avx,f16c")))
+static void decodeF16C(const uint16_t* src, int64_t n, float* dst) {
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+    for (; i < n; ++i) dst[i] = fromF16(src[i]);
+}
+
+__attribute__((target("avx2")))
+static void encodeBf16Avx2(const float* src, int64_t n, uint16_t* dst) {
+    const __m256i bias = _mm256_set1_epi32(0x7FFF), one = _mm256_set1_epi32(1);
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256  v = _mm256_loadu_ps(src + i);
+        __m256i u = _mm256_castps_si256(v);
+        __m256i r = _mm256_add_epi32(u, _mm256_add_epi32(bias, _mm256_and_si256(_mm256_srli_epi32(u, 16), one)));
+        __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+        r = _mm256_blendv_epi8(r, _mm256_or_si256(u, _mm256_set1_epi32(0x400000)), nan);
+        r = _mm256_srli_epi32(r, 16);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(r, r), 0xD8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(packed));
+    }
+    for (; i < n; ++i) dst[i] = toBf16(src[i]);
+}
+
+__attribute__((target("avx2")))
+static void decodeBf16Avx2(const uint16_t* src, int64_t n, float* dst) {
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i h = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(h, 16)));
+    }
+    for (; i < n; ++i) dst[i] = fromBf16(src[i]);
+}
+#endif
+
+namespace {
+struct Simd { bool f16c = false, avx2 = false; };
+const Simd& simd() {
+    static const Simd s = [] {
+        Simd r;
+#ifdef NEXA_DTYPE_X86
+        r.f16c = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+        r.avx2 = __builtin_cpu_supports("avx2");
+#endif
+        return r;
+    }();
+    return s;
+}
+} // namespace
+
+void encode(DType t, const float* src, int64_t n, void* dst, QuantParams q) {
+    switch (t) {
+    case DType::F32:
+        std::memcpy(dst, src, (size_t)n * 4);
+        return;
+    case DType::BF16: {
+        auto* d = static_cast<uint16_t*>(dst);
+#ifdef NEXA_DTYPE_X86
+        if (simd().avx2) { encodeBf16Avx2(src, n, d); return; }
+#endif
+        for (int64_t i = 0; i < n; ++i) d[i] = toBf16(src[i]);
+        return;
+    }
+    case DType::F16: {
+        auto* d = static_cast<uint16_t*>(dst);
+#ifdef NEXA_DTYPE_X86
+        if (simd().f16c) { encodeF16C(src, n, d); return; }
+#endif
+        for (int64_t i = 0; i < n; ++i) d[i] = toF16(src[i]);
+        return;
+    }
+    case DType::I8: {
+        auto* d = static_cast<int8_t*>(dst);
+        float inv = 1.f / q.scale;
+        for (int64_t i = 0; i < n; ++i) d[i] = toI8(src[i], inv, q.zeroPoint);
+        return;
+    }
+    }
+}
+
+void decode(DType t, const void* src, int64_t n, float* dst, QuantParams q) {
+    switch (t) {
+    case DType::F32:
+        std::memcpy(dst, src, (size_t)n * 4);
+        return;
+    case DType::BF16: {
+        auto* s = static_cast<const uint16_t*>(src);
+#ifdef NEXA_DTYPE_X86
+        if (simd().avx2) { decodeBf16Avx2(s, n, dst); return; }
+#endif
+        for (int64_t i = 0; i < n; ++i) dst[i] = fromBf16(s[i]);
+        return;
+    }
+    case DType::F16: {
+        auto* s = static_cast<const uint16_t*>(src);
+#ifdef NEXA_DTYPE_X86
+        if (simd().f16c) { decodeF16C(s, n, dst); return; }
+#endif
+        for (int64_t i = 0; i < n; ++i) dst[i] = fromF16(s[i]);
+        return;
+    }
+    case DType::I8: {
+        auto* s = static_cast<const int8_t*>(src);
+        const float scale = q.scale, zp = (float)q.zeroPoint;
+        for (int64_t i = 0; i < n; ++i) dst[i] = ((float)s[i] - zp) * scale;
+        return;
+    }
+    }
+}
+
+float decodeOne(DType t, const void* src, int64_t i, QuantParams q) {
+    switch (t) {
+    case DType::F32:  return static_cast<const float*>(src)[i];
+    case DType::BF16: return fromBf16(static_cast<const uint16_t*>(src)[i]);
+    case DType::F16:  return fromF16(static_cast<const uint16_t*>(src)[i]);
+    case DType::I8:   return ((float)static_cast<const int8_t*>(src)[i] - (float)q.zeroPoint) * q.scale;
+    }
+    return 0.f;
+}
+
+void encodeOne(DType t, float v, void* dst, int64_t i, QuantParams q) {
+    switch (t) {
+    case DType::F32:  static_cast<float*>(dst)[i]    = v;                                   return;
+    case DType::BF16: static_cast<uint16_t*>(dst)[i] = toBf16(v);                           return;
+    case DType::F16:  static_cast<uint16_t*>(dst)[i] = toF16(v);                            return;
+    case DType::I8:   static_cast<int8_t*>(dst)[i]   = toI8(v, 1.f / q.scale, q.zeroPoint); return;
+    }
+}
+
+} // namespace nexa
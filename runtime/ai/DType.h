@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace nexa {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Element types for tensor storage.
+//
+//   F32   4 bytes   the compute type: every kernel accumulates in fp32
+//   BF16  2 bytes   fp32 with the mantissa cut to 7 bits (same range)
+//   F16   2 bytes   IEEE half: 10-bit mantissa, max ±65504
+//   I8    1 byte    affine-quantised: value = (q - zeroPoint) * scale
+//
+// Reduced types are a storage format only. Kernels read them through
+// decode() into fp32 blocks (F16C / AVX2 when the CPU has them), so they
+// move half or a quarter of the bytes of an fp32 tensor but compute the same
+// way. Conversions to BF16 / F16 round to nearest even.
+// ─────────────────────────────────────────────────────────────────────────────
+enum class DType : int32_t { F32 = 0, BF16 = 1, F16 = 2, I8 = 3 };
+
+size_t      dtypeSize(DType t);
+const char* dtypeName(DType t);           // "f32", "bf16", "f16", "i8"
+
+// Per-tensor int8 quantisation parameters (ignored by the other types).
+struct QuantParams {
+    float   scale     = 1.f;
+    int32_t zeroPoint = 0;
+};
+
+// Scale / zero point that map [lo, hi] (widened to include 0) onto [-128, 127].
+QuantParams chooseQuantParams(float lo, float hi);
+
+// n contiguous elements between fp32 and the storage type.
+void  encode(DType t, const float* src, int64_t n, void* dst, QuantParams q = {});
+void  decode(DType t, const void* src, int64_t n, float* dst, QuantParams q = {});
+
+// Element i of a buffer of type t.
+float decodeOne(DType t, const void* src, int64_t i, QuantParams q = {});
+void  encodeOne(DType t, float v, void* dst, int64_t i, QuantParams q = {});
+
+} // namespace nexa
@@ -0,0 +1,244 @@
+#include "Tensor.h"
+#include "Lazy.h"
+#include "Parallel.h"
+#include "Small.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Element-wise tensor arithmetic: + - * / between two tensors (with
+// broadcasting) or between a tensor and a scalar.
+//
+// Broadcasting follows the usual rule per dimension, with shapes aligned on
+// their last dimension: sizes must match or one of them must be 1, and a
+// missing leading dimension counts as 1. For matrices that covers
+//   [m x n] op [m x n]     plain element-wise
+//   [m x n] op [1 x n]     row vector added to every row
+//   [m x n] op [m x 1]     column vector added to every column
+//   [m x n] op [1 x 1]     scalar tensor
+// and the same rules extend to batches, e.g. [b x m x n] op [m x n].
+// A broadcast operand is walked with stride 0, so nothing is ever expanded.
+// Operands may be strided views; their own strides are used directly.
+// bf16 / f16 / i8 operands are decoded to f32 first; results are always f32.
+// In lazy mode (Lazy.h) the same calls only record the op; the broadcast
+// rules are checked here either way.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace {
+
+struct Add { static constexpr nexa::LazyOp kind = nexa::LazyOp::Add; float operator()(float x, float y) const { return x + y; } };
+struct Sub { static constexpr nexa::LazyOp kind = nexa::LazyOp::Sub; float operator()(float x, float y) const { return x - y; } };
+struct Mul { static constexpr nexa::LazyOp kind = nexa::LazyOp::Mul; float operator()(float x, float y) const { return x * y; } };
+struct Div { static constexpr nexa::LazyOp kind = nexa::LazyOp::Div; float operator()(float x, float y) const { return x / y; } };
+
+// Minimum elements per thread before the pool is used.
+constexpr int64_t ELEMENTWISE_GRAIN = 1 << 15;
+
+// Row offsets for plain matrices: row i of a starts at a + i*ars.
+struct MatrixRows {
+    std::ptrdiff_t ars, brs;
+    void operator()(int64_t i, std::ptrdiff_t& ao, std::ptrdiff_t& bo) const { ao = i * ars; bo = i * brs; }
+};
+
+// out[i][j] = op(a[ao(i) + j*acs], b[bo(i) + j*bcs]), where rowOffsets maps
+// output row i to the start of the matching operand rows.
+// Column strides of 0 (broadcast) and 1 (dense) get their own inner loops so
+// the compiler can vectorise them; anything else takes the generic loop.
+template <typename Op, typename Rows = MatrixRows>
+void binaryKernel(int64_t rows, int cols,
+                  const float* a, std::ptrdiff_t acs,
+                  const float* b, std::ptrdiff_t bcs,
+                  float* out, Op op, Rows rowOffsets) {
+    int64_t grain = std::max<int64_t>(1, ELEMENTWISE_GRAIN / std::max(cols, 1));
+    nexa::parallel_for(rows, grain, [&](int64_t rb, int64_t re, int) {
+        for (int64_t i = rb; i < re; ++i) {
+            std::ptrdiff_t ao, bo;
+            rowOffsets(i, ao, bo);
+            const float* __restrict ar = a + ao;
+            const float* __restrict br = b + bo;
+            float*       __restrict o  = out + i * cols;
+            if (acs == 1 && bcs == 1) {
+                for (int j = 0; j < cols; ++j) o[j] = op(ar[j], br[j]);
+            } else if (acs == 1 && bcs == 0) {
+                const float bv = br[0];
+                for (int j = 0; j < cols; ++j) o[j] = op(ar[j], bv);
+            } else if (acs == 0 && bcs == 1) {
+                const float av = ar[0];
+                for (int j = 0; j < cols; ++j) o[j] = op(av, br[j]);
+            } else if (acs == 0 && bcs == 0) {
+                const float v = op(ar[0], br[0]);
+                for (int j = 0; j < cols; ++j) o[j] = v;
+            } else {
+                for (int j = 0; j < cols; ++j) o[j] = op(ar[j * acs], br[j * bcs]);
+            }
+        }
+    });
+}
+
+bool broadcastDim(int x, int y, int& out) {
+    if (x == y) { out = x; return true; }
+    if (x == 1) { out = y; return true; }
+    if (y == 1) { out = x; return true; }
+    return false;
+}
+
+// Row offsets for batched operands: output row i is split into a batch index
+// (over the leading dimensions of `shape`) and a row within the matrix.
+struct BatchRows {
+    const std::vector<int>&            shape;     // output shape, ndim >= 3
+    const std::vector<std::ptrdiff_t>& as;        // operand strides, 0 where broadcast
+    const std::vector<std::ptrdiff_t>& bs;
+    void operator()(int64_t i, std::ptrdiff_t& ao, std::ptrdiff_t& bo) const {
+        int nd = (int)shape.size();
+        int64_t r = i % shape[nd - 2], rem = i / shape[nd - 2];
+        ao = r * as[nd - 2];
+        bo = r * bs[nd - 2];
+        for (int d = nd - 3; d >= 0 && rem; --d) {
+            int64_t idx = rem % shape[d];
+            rem /= shape[d];
+            ao += idx * as[d];
+            bo += idx * bs[d];
+        }
+    }
+};
+
+std::string shapeStr(const std::vector<int>& s) {
+    std::string r = "[";
+    for (size_t d = 0; d < s.size(); ++d) r += (d ? " x " : "") + std::to_string(s[d]);
+    return r + "]";
+}
+
+// Shape padded with leading 1s to nd dimensions; strides 0 wherever size is 1
+void alignTo(const nexa::Tensor& t, int nd, std::vector<int>& shape, std::vector<std::ptrdiff_t>& strides) {
+    shape.assign(nd, 1);
+    strides.assign(nd, 0);
+    for (int d = 0, k = nd - t.ndim(); d < t.ndim(); ++d) {
+        shape[k + d]   = t.shape[d];
+        strides[k + d] = t.shape[d] == 1 ? 0 : t.strides[d];
+    }
+}
+
+const nexa::Tensor* asF32(const nexa::Tensor* t, nexa::Tensor& tmp) {
+    if (t->dtype == nexa::DType::F32) return t;
+    tmp = t->converted(nexa::DType::F32);
+    return &tmp;
+}
+
+template <typename Op>
+void* tensorTensor(const char* name, void* ap, void* bp, Op op) {
+    auto* pa = static_cast<nexa::Tensor*>(ap);
+    auto* pb = static_cast<nexa::Tensor*>(bp);
+    if (!nexa::lazyEnabled())
+        if (auto* small = smallSame(pa, pb, op)) return small;   // pending operands have no elems
+    int nd = std::max({pa->ndim(), pb->ndim(), 2});
+    std::vector<int> as, bs, shape(nd);
+    std::vector<std::ptrdiff_t> ast, bst;
+    alignTo(*pa, nd, as, ast);
+    alignTo(*pb, nd, bs, bst);
+    for (int d = 0; d < nd; ++d) {
+        if (!broadcastDim(as[d], bs[d], shape[d])) {
+            fprintf(stderr, "[nexa] %s shape mismatch: %s vs %s\n",
+                    name, shapeStr(pa->shape).c_str(), shapeStr(pb->shape).c_str());
+            return nullptr;
+        }
+    }
+    if (nexa::lazyEnabled()) return nexa::lazyBinary(Op::kind, pa, pb, shape);
+
+    nexa::Tensor ta, tb;
+    const nexa::Tensor* A = asF32(nexa::tensorArg(ap), ta);
+    const nexa::Tensor* B = asF32(nexa::tensorArg(bp), tb);
+    alignTo(*A, nd, as, ast);
+    alignTo(*B, nd, bs, bst);
+    int64_t rows = 1;
+    for (int d = 0; d < nd - 1; ++d) rows *= shape[d];
+    int cols = shape[nd - 1];
+    auto* out = new nexa::Tensor(nexa::FloatBuffer((size_t)rows * cols), shape);
+    if (nd == 2)
+        binaryKernel(rows, cols, A->data(), ast[1], B->data(), bst[1], out->data(), op,
+                     MatrixRows{ast[0], bst[0]});
+    else
+        binaryKernel(rows, cols, A->data(), ast[nd - 1], B->data(), bst[nd - 1], out->data(), op,
+                     BatchRows{shape, ast, bst});
+    return out;
+}
+
+// Same-shape dense f32 square operands of a size with an unrolled kernel
+// (Small.h); nullptr when the fixed-size path does not apply.
+template <typename Op>
+nexa::Tensor* smallSame(const nexa::Tensor* A, const nexa::Tensor* B, Op op) {
+    if (A->ndim() != 2 || A->shape != B->shape || A->rows != A->cols || !nexa::smallSize(A->rows) ||
+        !A->elems || !B->elems || !A->isContiguous() || !B->isContiguous())
+        return nullptr;
+    nexa::Tensor* out = nexa::smallTensor((int)A->rows);
+    switch (A->rows) {
+    case 2: nexa::smallBinary<2>(A->data(), B->data(), out->data(), op); break;
+    case 3: nexa::smallBinary<3>(A->data(), B->data(), out->data(), op); break;
+    case 4: nexa::smallBinary<4>(A->data(), B->data(), out->data(), op); break;
+    case 8: nexa::smallBinary<8>(A->data(), B->data(), out->data(), op); break;
+    }
+    return out;
+}
+
+// a op b for operands the compiler has already proven to have the same static
+// shape: no broadcast resolution, every row is a plain [rows x cols] pass.
+template <typename Op>
+void* sameShape(void* ap, void* bp, Op op) {
+    auto* pa = static_cast<nexa::Tensor*>(ap);
+    if (nexa::lazyEnabled()) {
+        std::vector<int> shape = pa->shape;
+        if (shape.size() < 2) shape.insert(shape.begin(), 2 - shape.size(), 1);
+        return nexa::lazyBinary(Op::kind, pa, static_cast<nexa::Tensor*>(bp), shape);
+    }
+    if (auto* small = smallSame(pa, static_cast<nexa::Tensor*>(bp), op)) return small;
+    nexa::Tensor ta, tb;
+    const nexa::Tensor* A = asF32(nexa::tensorArg(ap), ta);
+    const nexa::Tensor* B = asF32(nexa::tensorArg(bp), tb);
+    if (A->ndim() > 2 || B->ndim() > 2)     // batched views: rows aren't one stride apart
+        return tensorTensor("same", ap, bp, op);
+    auto* out = new nexa::Tensor(nexa::FloatBuffer(A->numel()), A->shape);
+    binaryKernel(A->rows, (int)A->cols, A->data(), A->colStride, B->data(), B->colStride,
+                 out->data(), op, MatrixRows{A->rowStride, B->rowStride});
+    return out;
+}
+
+// scalarLeft: s op t instead of t op s (only matters for - and /).
+// The tensor is walked as its flattened [rows x cols] matrix.
+template <typename Op>
+void* tensorScalar(void* tp, float s, bool scalarLeft, Op op) {
+    if (nexa::lazyEnabled()) return nexa::lazyScalar(Op::kind, static_cast<nexa::Tensor*>(tp), s, scalarLeft);
+    nexa::Tensor tt;
+    const nexa::Tensor* T = asF32(nexa::tensorArg(tp), tt);
+    auto* out = new nexa::Tensor(nexa::FloatBuffer(T->numel()), T->shape);
+    const float* t = T->data();
+    std::ptrdiff_t rs = T->rowStride, cs = T->colStride;
+    int cols = (int)T->cols;
+    if (scalarLeft) binaryKernel(T->rows, cols, &s, 0, t, cs, out->data(), op, MatrixRows{0, rs});
+    else            binaryKernel(T->rows, cols, t, cs, &s, 0, out->data(), op, MatrixRows{rs, 0});
+    return out;
+}
+
+} // namespace
+
+extern "C" {
+
+void* ai_add(void* a, void* b) { return tensorTensor("add", a, b, Add{}); }
+void* ai_sub(void* a, void* b) { return tensorTensor("sub", a, b, Sub{}); }
+void* ai_mul(void* a, void* b) { return tensorTensor("hadamard", a, b, Mul{}); }
+void* ai_div(void* a, void* b) { return tensorTensor("div", a, b, Div{}); }
+
+void* ai_add_same(void* a, void* b) { return sameShape(a, b, Add{}); }
+void* ai_sub_same(void* a, void* b) { return sameShape(a, b, Sub{}); }
+void* ai_mul_same(void* a, void* b) { return sameShape(a, b, Mul{}); }
+void* ai_div_same(void* a, void* b) { return sameShape(a, b, Div{}); }
+
+void* ai_add_scalar (void* t, float s) { return tensorScalar(t, s, false, Add{}); }
+void* ai_sub_scalar (void* t, float s) { return tensorScalar(t, s, false, Sub{}); }
+void* ai_mul_scalar (void* t, float s) { return tensorScalar(t, s, false, Mul{}); }
+void* ai_div_scalar (void* t, float s) { return tensorScalar(t, s, false, Div{}); }
+void* ai_rsub_scalar(void* t, float s) { return tensorScalar(t, s, true,  Sub{}); }
+void* ai_rdiv_scalar(void* t, float s) { return tensorScalar(t, s, true,  Div{}); }
+
+} // extern "C"
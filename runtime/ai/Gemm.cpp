@@ -0,0 +1,530 @@
+#include "Gemm.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define NEXA_GEMM_X86 1
+#endif
+
+namespace nexa {
+
+// ── Blocking parameters ───────────────────────────────────────────────────────
+// MR x NR is the register tile (6 x 16 floats = 12 ymm accumulators).
+// MC x KC of packed A ≈ 120 KB → L2;  KC x NC of packed B ≈ 3 MB → L3.
+static constexpr int MR = 6;
+static constexpr int NR = 16;
+static constexpr int KC = 256;
+static constexpr int MC = 120;   // multiple of MR
+static constexpr int NC = 3072;  // multiple of NR
+
+// Below this many multiply-adds, packing costs more than it saves.
+static constexpr long long SMALL_GEMM_FLOPS = 48LL * 48 * 48;
+
+// Below this many multiply-adds, waking the thread pool costs more than it saves.
+static constexpr long long PARALLEL_GEMM_FLOPS = 128LL * 128 * 128;
+static constexpr long long PARALLEL_GEMV_FLOPS = 1LL << 16;
+
+// ── Packing buffers ───────────────────────────────────────────────────────────
+// 64-byte aligned, grown on demand. Packed B is shared by every thread working
+// on a call; packed A is per thread.
+namespace {
+struct PackBuffer {
+    float* ptr = nullptr;
+    size_t cap = 0;
+    float* get(size_t n) {
+        if (n > cap) {
+            if (ptr) ::operator delete(ptr, std::align_val_t(64));
+            ptr = static_cast<float*>(::operator new(n * sizeof(float), std::align_val_t(64)));
+            cap = n;
+        }
+        return ptr;
+    }
+    ~PackBuffer() { if (ptr) ::operator delete(ptr, std::align_val_t(64)); }
+};
+} // namespace
+
+// Operands are addressed through a row and a column stride: element (i, k)
+// of A is A[i*ars + k*acs]. A plain row-major operand has a column stride of
+// 1; a transposed one (the other matrix stored row-major) has a row stride of
+// 1. Only the packing routines and the small-problem paths see the strides —
+// the micro-kernel always reads packed panels, so op(A) / op(B) cost nothing
+// beyond a different gather order while packing.
+
+// Pack an mc x kc block of A into MR-row panels: for each k, MR consecutive
+// values. Rows past mc are zero-padded so the micro-kernel never branches.
+static void packA(int mc, int kc, const float* A, std::ptrdiff_t ars, std::ptrdiff_t acs, float* out) {
+    for (int ir = 0; ir < mc; ir += MR) {
+        int m = std::min(MR, mc - ir);
+        const float* a = A + (std::ptrdiff_t)ir * ars;
+        for (int p = 0; p < kc; ++p) {
+            const float* col = a + (std::ptrdiff_t)p * acs;
+            int i = 0;
+            for (; i < m;  ++i) out[i] = col[i * ars];
+            for (; i < MR; ++i) out[i] = 0.f;
+            out += MR;
+        }
+    }
+}
+
+// Pack a kc x nc block of B into NR-column panels: for each k, NR consecutive
+// values. Columns past nc are zero-padded.
+static void packB(int kc, int nc, const float* B, std::ptrdiff_t brs, std::ptrdiff_t bcs, float* out) {
+    for (int jr = 0; jr < nc; jr += NR) {
+        int n = std::min(NR, nc - jr);
+        const float* b = B + (std::ptrdiff_t)jr * bcs;
+        if (bcs != 1) {
+            // transposed B: walk each column of the panel along k (contiguous)
+            for (int j = 0; j < NR; ++j) {
+                if (j >= n) { for (int p = 0; p < kc; ++p) out[p * NR + j] = 0.f; continue; }
+                const float* col = b + (std::ptrdiff_t)j * bcs;
+                for (int p = 0; p < kc; ++p) out[p * NR + j] = col[p * brs];
+            }
+            out += (std::ptrdiff_t)kc * NR;
+            continue;
+        }
+        for (int p = 0; p < kc; ++p) {
+            const float* row = b + (std::ptrdiff_t)p * brs;
+            if (n == NR) std::memcpy(out, row, NR * sizeof(float));
+            else {
+                int j = 0;
+                for (; j < n;  ++j) out[j] = row[j];
+                for (; j < NR; ++j) out[j] = 0.f;
+            }
+            out += NR;
+        }
+    }
+}
+
+// ── Micro-kernels ─────────────────────────────────────────────────────────────
+// c[MR x NR] (=|+=) a_panel * b_panel over kc steps.
+using MicroKernel = void (*)(int kc, const float* a, const float* b,
+                             float* c, std::ptrdiff_t ldc, bool accumulate);
+
+static void kernelGeneric(int kc, const float* a, const float* b,
+                          float* c, std::ptrdiff_t ldc, bool accumulate) {
+    float acc[MR][NR] = {};
+    for (int p = 0; p < kc; ++p) {
+        for (int i = 0; i < MR; ++i) {
+            float av = a[i];
+            for (int j = 0; j < NR; ++j) acc[i][j] += av * b[j];
+        }
+        a += MR;
+        b += NR;
+    }
+    for (int i = 0; i < MR; ++i) {
+        float* row = c + i * ldc;
+        if (accumulate) for (int j = 0; j < NR; ++j) row[j] += acc[i][j];
+        else            for (int j = 0; j < NR; ++j) row[j]  = acc[i][j];
+    }
+}
+
+#ifdef NEXA_GEMM_X86
+__attribute__((target("avx2,fma")))
+static inline void storeRowAvx2(float* row, __m256 lo, __m256 hi, bool accumulate) {
+    if (accumulate) {
+        lo = _mm256_add_ps(lo, _mm256_loadu_ps(row));
+        hi = _mm256_add_ps(hi, _mm256_loadu_ps(row + 8));
+    }
+    _mm256_storeu_ps(row,     lo);
+    _mm256_storeu_ps(row + 8, hi);
+}
+
+__attribute__((target("avx2,fma")))
+static void kernelAvx2(int kc, const float* a, const float* b,
+                       float* c, std::ptrdiff_t ldc, bool accumulate) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (int p = 0; p < kc; ++p) {
+        __m256 b0 = _mm256_load_ps(b);
+        __m256 b1 = _mm256_load_ps(b + 8);
+        __m256 av;
+        av = _mm256_broadcast_ss(a + 0); c00 = _mm256_fmadd_ps(av, b0, c00); c01 = _mm256_fmadd_ps(av, b1, c01);
+        av = _mm256_broadcast_ss(a + 1); c10 = _mm256_fmadd_ps(av, b0, c10); c11 = _mm256_fmadd_ps(av, b1, c11);
+        av = _mm256_broadcast_ss(a + 2); c20 = _mm256_fmadd_ps(av, b0, c20); c21 = _mm256_fmadd_ps(av, b1, c21);
+        av = _mm256_broadcast_ss(a + 3); c30 = _mm256_fmadd_ps(av, b0, c30); c31 = _mm256_fmadd_ps(av, b1, c31);
+        av = _mm256_broadcast_ss(a + 4); c40 = _mm256_fmadd_ps(av, b0, c40); c41 = _mm256_fmadd_ps(av, b1, c41);
+        av = _mm256_broadcast_ss(a + 5); c50 = _mm256_fmadd_ps(av, b0, c50); c51 = _mm256_fmadd_ps(av, b1, c51);
+        a += MR;
+        b += NR;
+    }
+
+    storeRowAvx2(c + 0 * ldc, c00, c01, accumulate);
+    storeRowAvx2(c + 1 * ldc, c10, c11, accumulate);
+    storeRowAvx2(c + 2 * ldc, c20, c21, accumulate);
+    storeRowAvx2(c + 3 * ldc, c30, c31, accumulate);
+    storeRowAvx2(c + 4 * ldc, c40, c41, accumulate);
+    storeRowAvx2(c + 5 * ldc, c50, c51, accumulate);
+}
+#endif
+
+static MicroKernel selectKernel() {
+#ifdef NEXA_GEMM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return kernelAvx2;
+#endif
+    return kernelGeneric;
+}
+
+static MicroKernel microKernel() {
+    static const MicroKernel k = selectKernel();
+    return k;
+}
+
+const char* sgemm_kernel_name() {
+#ifdef NEXA_GEMM_X86
+    if (microKernel() == kernelAvx2) return "avx2-fma";
+#endif
+    return "generic";
+}
+
+// ── Macro-kernel ──────────────────────────────────────────────────────────────
+// Walks one packed mc x kc block of A against one packed kc x nc block of B.
+// Full tiles go straight to C; edge tiles go through a scratch tile.
+static void macroKernel(int mc, int nc, int kc, const float* pa, const float* pb,
+                        float* C, std::ptrdiff_t ldc, bool accumulate) {
+    MicroKernel kernel = microKernel();
+    alignas(64) float tile[MR * NR];
+
+    for (int jr = 0; jr < nc; jr += NR) {
+        int n = std::min(NR, nc - jr);
+        const float* b = pb + (std::ptrdiff_t)jr * kc;
+        for (int ir = 0; ir < mc; ir += MR) {
+            int m = std::min(MR, mc - ir);
+            const float* a = pa + (std::ptrdiff_t)ir * kc;
+            float* c = C + (std::ptrdiff_t)ir * ldc + jr;
+
+            if (m == MR && n == NR) {
+                kernel(kc, a, b, c, ldc, accumulate);
+                continue;
+            }
+            kernel(kc, a, b, tile, NR, false);
+            for (int i = 0; i < m; ++i) {
+                float* row = c + i * ldc;
+                const float* t = tile + i * NR;
+                if (accumulate) for (int j = 0; j < n; ++j) row[j] += t[j];
+                else            for (int j = 0; j < n; ++j) row[j]  = t[j];
+            }
+        }
+    }
+}
+
+// ── Small problems ────────────────────────────────────────────────────────────
+// Row-major B: i-k-j order, the inner loop is a contiguous axpy over a row of
+// B and C. Transposed B with row-major A: each C element is a dot product of
+// two contiguous rows. Anything else gathers through the strides.
+static void sgemmSmall(int M, int N, int K,
+                       const float* A, std::ptrdiff_t ars, std::ptrdiff_t acs,
+                       const float* B, std::ptrdiff_t brs, std::ptrdiff_t bcs,
+                       float* C, std::ptrdiff_t ldc) {
+    if (bcs == 1) {
+        for (int i = 0; i < M; ++i) {
+            float* c = C + i * ldc;
+            std::fill(c, c + N, 0.f);
+            for (int p = 0; p < K; ++p) {
+                float a = A[i * ars + p * acs];
+                const float* b = B + p * brs;
+                for (int j = 0; j < N; ++j) c[j] += a * b[j];
+            }
+        }
+        return;
+    }
+    if (acs == 1 && brs == 1) {
+        for (int i = 0; i < M; ++i) {
+            const float* a = A + i * ars;
+            for (int j = 0; j < N; ++j) {
+                const float* b = B + j * bcs;
+                float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+                int p = 0;
+                for (; p + 4 <= K; p += 4) {
+                    s0 += a[p] * b[p];         s1 += a[p + 1] * b[p + 1];
+                    s2 += a[p + 2] * b[p + 2]; s3 += a[p + 3] * b[p + 3];
+                }
+                for (; p < K; ++p) s0 += a[p] * b[p];
+                C[i * ldc + j] = (s0 + s1) + (s2 + s3);
+            }
+        }
+        return;
+    }
+    for (int i = 0; i < M; ++i)
+        for (int j = 0; j < N; ++j) {
+            float s = 0.f;
+            for (int p = 0; p < K; ++p) s += A[i * ars + p * acs] * B[p * brs + j * bcs];
+            C[i * ldc + j] = s;
+        }
+}
+
+// N == 1 (matrix x column vector): one dot product per row of A. Packing a
+// single column would waste 15/16 of every micro-kernel tile.
+static void sgemvRows(int rowBegin, int rowEnd, int K,
+                      const float* A, std::ptrdiff_t lda,
+                      const float* x, std::ptrdiff_t incx,
+                      float* y, std::ptrdiff_t incy) {
+    for (int i = rowBegin; i < rowEnd; ++i) {
+        const float* a = A + i * lda;
+        float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+        int p = 0;
+        if (incx == 1) {
+            for (; p + 4 <= K; p += 4) {
+                s0 += a[p]     * x[p];
+                s1 += a[p + 1] * x[p + 1];
+                s2 += a[p + 2] * x[p + 2];
+                s3 += a[p + 3] * x[p + 3];
+            }
+        }
+        for (; p < K; ++p) s0 += a[p] * x[p * incx];
+        y[i * incy] = (s0 + s1) + (s2 + s3);
+    }
+}
+
+static void sgemv(int M, int K,
+                  const float* A, std::ptrdiff_t lda,
+                  const float* x, std::ptrdiff_t incx,
+                  float* y, std::ptrdiff_t incy) {
+    int64_t grain = (long long)M * K >= PARALLEL_GEMV_FLOPS ? std::max(1, (1 << 14) / K) : M;
+    parallel_for(M, grain, [&](int64_t b, int64_t e, int) {
+        sgemvRows((int)b, (int)e, K, A, lda, x, incx, y, incy);
+    });
+}
+
+static void gemm(int M, int N, int K,
+                 const float* A, std::ptrdiff_t ars, std::ptrdiff_t acs,
+                 const float* B, std::ptrdiff_t brs, std::ptrdiff_t bcs,
+                 float*       C, std::ptrdiff_t ldc) {
+    if (M <= 0 || N <= 0) return;
+    if (K <= 0) {
+        for (int i = 0; i < M; ++i) std::fill(C + i * ldc, C + i * ldc + N, 0.f);
+        return;
+    }
+    if (N == 1 && acs == 1) {
+        sgemv(M, K, A, ars, B, brs, C, ldc);
+        return;
+    }
+    if (M == 1 || (long long)M * N * K <= SMALL_GEMM_FLOPS) {
+        sgemmSmall(M, N, K, A, ars, acs, B, brs, bcs, C, ldc);
+        return;
+    }
+
+    // Row-panel partitioning: each thread owns a contiguous range of MR-row
+    // panels of A/C, packs its own A blocks and reads the shared packed B.
+    // parallel_for returning is the barrier before B is repacked.
+    const bool    threaded = (long long)M * N * K >= PARALLEL_GEMM_FLOPS;
+    const int64_t panels   = (M + MR - 1) / MR;
+
+    static thread_local PackBuffer bufB;
+    float* pb = bufB.get((size_t)KC * NC);
+
+    for (int jc = 0; jc < N; jc += NC) {
+        int nc = std::min(NC, N - jc);
+        for (int pc = 0; pc < K; pc += KC) {
+            int kc = std::min(KC, K - pc);
+            const float* b = B + (std::ptrdiff_t)pc * brs + (std::ptrdiff_t)jc * bcs;
+            const int64_t bPanels = (nc + NR - 1) / NR;
+            parallel_for(bPanels, threaded ? 8 : bPanels, [&](int64_t jb, int64_t je, int) {
+                int j0 = (int)jb * NR, j1 = std::min(nc, (int)je * NR);
+                packB(kc, j1 - j0, b + (std::ptrdiff_t)j0 * bcs, brs, bcs, pb + (std::ptrdiff_t)j0 * kc);
+            });
+
+            parallel_for(panels, threaded ? 1 : panels, [&](int64_t pbeg, int64_t pend, int) {
+                static thread_local PackBuffer bufA;
+                float* pa = bufA.get((size_t)MC * KC);
+                int rowBegin = (int)pbeg * MR;
+                int rowEnd   = std::min(M, (int)pend * MR);
+                for (int ic = rowBegin; ic < rowEnd; ic += MC) {
+                    int mc = std::min(MC, rowEnd - ic);
+                    packA(mc, kc, A + (std::ptrdiff_t)ic * ars + (std::ptrdiff_t)pc * acs, ars, acs, pa);
+                    macroKernel(mc, nc, kc, pa, pb,
+                                C + (std::ptrdiff_t)ic * ldc + jc, ldc, pc > 0);
+                }
+            });
+        }
+    }
+}
+
+void sgemm(int M, int N, int K,
+           const float* A, std::ptrdiff_t lda,
+           const float* B, std::ptrdiff_t ldb,
+           float*       C, std::ptrdiff_t ldc) {
+    gemm(M, N, K, A, lda, 1, B, ldb, 1, C, ldc);
+}
+
+void sgemm(Transpose ta, Transpose tb, int M, int N, int K,
+           const float* A, std::ptrdiff_t lda,
+           const float* B, std::ptrdiff_t ldb,
+           float*       C, std::ptrdiff_t ldc) {
+    bool tA = ta == Transpose::Yes, tB = tb == Transpose::Yes;
+    gemm(M, N, K, A, tA ? 1 : lda, tA ? lda : 1, B, tB ? 1 : ldb, tB ? ldb : 1, C, ldc);
+}
+
+void sgemm_batched(int batch, int M, int N, int K,
+                   const float* const* A, std::ptrdiff_t lda,
+                   const float* const* B, std::ptrdiff_t ldb,
+                   float* const*       C, std::ptrdiff_t ldc) {
+    if (batch <= 0) return;
+
+    // Shared B with A and C slices laid out one after another: [batch*M x K] * B
+    bool stacked = true;
+    for (int i = 1; i < batch && stacked; ++i)
+        stacked = B[i] == B[0] && A[i] == A[0] + (std::ptrdiff_t)i * M * lda
+                               && C[i] == C[0] + (std::ptrdiff_t)i * M * ldc;
+    if (stacked && (long long)batch * M <= INT32_MAX) {
+        sgemm(batch * M, N, K, A[0], lda, B[0], ldb, C[0], ldc);
+        return;
+    }
+
+    const long long flops = std::max(1LL, (long long)M * N * K);
+    if (flops >= PARALLEL_GEMM_FLOPS) {
+        for (int i = 0; i < batch; ++i) sgemm(M, N, K, A[i], lda, B[i], ldb, C[i], ldc);
+        return;
+    }
+    // Small matrices: one thread per group of matrices; the nested sgemm
+    // calls run inline on the worker that owns them.
+    parallel_for(batch, std::max(1LL, PARALLEL_GEMM_FLOPS / flops), [&](int64_t b, int64_t e, int) {
+        for (int64_t i = b; i < e; ++i) sgemm(M, N, K, A[i], lda, B[i], ldb, C[i], ldc);
+    });
+}
+
+// ── Int8 GEMM ─────────────────────────────────────────────────────────────────
+// B is packed once as int16 pairs, bp[(kk*N + j)*2 + t] = B[2kk+t][j] - zb, so
+// one 32-bit broadcast of (a[2kk], a[2kk+1]) times a row of pairs is a single
+// multiply-add of two k steps for 8 columns.
+
+static void qgemmRowGeneric(int N, int Kp, const int32_t* ap, const int16_t* bp, int32_t* acc) {
+    std::fill(acc, acc + N, 0);
+    for (int kk = 0; kk < Kp; ++kk) {
+        int32_t a0 = (int16_t)(ap[kk] & 0xFFFF), a1 = ap[kk] >> 16;
+        const int16_t* b = bp + (std::ptrdiff_t)kk * N * 2;
+        for (int j = 0; j < N; ++j) acc[j] += a0 * b[2 * j] + a1 * b[2 * j + 1];
+    }
+}
+
+#ifdef NEXA_GEMM_X86
+__attribute__((target("avx2")))
+static void qgemmRowAvx2(int N, int Kp, const int32_t* ap, const int16_t* bp, int32_t* acc) {
+    int j = 0;
+    for (; j + 32 <= N; j += 32) {
+        __m256i c0 = _mm256_setzero_si256(), c1 = _mm256_setzero_si256();
+        __m256i c2 = _mm256_setzero_si256(), c3 = _mm256_setzero_si256();
+        for (int kk = 0; kk < Kp; ++kk) {
+            __m256i a = _mm256_set1_epi32(ap[kk]);
+            const int16_t* b = bp + ((std::ptrdiff_t)kk * N + j) * 2;
+            c0 = _mm256_add_epi32(c0, _mm256_madd_epi16(a, _mm256_loadu_si256((const __m256i*)(b))));
+            c1 = _mm256_add_epi32(c1, _mm256_madd_epi16(a, _mm256_loadu_si256((const __m256i*)(b + 16))));
+            c2 = _mm256_add_epi32(c2, _mm256_madd_epi16(a, _mm256_loadu_si256((const __m256i*)(b + 32))));
+            c3 = _mm256_add_epi32(c3, _mm256_madd_epi16(a, _mm256_loadu_si256((const __m256i*)(b + 48))));
+        }
+        _mm256_storeu_si256((__m256i*)(acc + j),      c0);
+        _mm256_storeu_si256((__m256i*)(acc + j + 8),  c1);
+        _mm256_storeu_si256((__m256i*)(acc + j + 16), c2);
+        _mm256_storeu_si256((__m256i*)(acc + j + 24), c3);
+    }
+    for (; j + 8 <= N; j += 8) {
+        __m256i c = _mm256_setzero_si256();
+        for (int kk = 0; kk < Kp; ++kk)
+            c = _mm256_add_epi32(c, _mm256_madd_epi16(_mm256_set1_epi32(ap[kk]),
+                    _mm256_loadu_si256((const __m256i*)(bp + ((std::ptrdiff_t)kk * N + j) * 2))));
+        _mm256_storeu_si256((__m256i*)(acc + j), c);
+    }
+    for (; j < N; ++j) {
+        int32_t s = 0;
+        for (int kk = 0; kk < Kp; ++kk) {
+            const int16_t* b = bp + ((std::ptrdiff_t)kk * N + j) * 2;
+            s += (int16_t)(ap[kk] & 0xFFFF) * b[0] + (ap[kk] >> 16) * b[1];
+        }
+        acc[j] = s;
+    }
+}
+#endif
+
+void qgemm_s8(int M, int N, int K,
+              const int8_t* A, std::ptrdiff_t lda, int32_t za,
+              const int8_t* B, std::ptrdiff_t ldb, int32_t zb,
+              float scale, float* C, std::ptrdiff_t ldc) {
+    if (M <= 0 || N <= 0) return;
+    const int Kp = (K + 1) / 2;
+    std::vector<int16_t> bp((size_t)Kp * N * 2, 0);
+    for (int k = 0; k < K; ++k)
+        for (int j = 0; j < N; ++j)
+            bp[((size_t)(k / 2) * N + j) * 2 + (k & 1)] = (int16_t)(B[k * ldb + j] - zb);
+
+    auto row = qgemmRowGeneric;
+#ifdef NEXA_GEMM_X86
+    if (__builtin_cpu_supports("avx2")) row = qgemmRowAvx2;
+#endif
+    long long flops = (long long)N * std::max(K, 1);
+    int64_t grain = flops * M >= PARALLEL_GEMM_FLOPS ? std::max(1LL, PARALLEL_GEMM_FLOPS / 16 / flops) : M;
+    parallel_for(M, grain, [&](int64_t b, int64_t e, int) {
+        std::vector<int32_t> ap(Kp), acc(N);
+        for (int64_t i = b; i < e; ++i) {
+            const int8_t* a = A + i * lda;
+            for (int kk = 0; kk < Kp; ++kk) {
+                int32_t lo = a[2 * kk] - za;
+                int32_t hi = 2 * kk + 1 < K ? a[2 * kk + 1] - za : 0;
+                ap[kk] = (int32_t)(((uint32_t)hi << 16) | ((uint32_t)lo & 0xFFFF));
+            }
+            row(N, Kp, ap.data(), bp.data(), acc.data());
+            float* c = C + i * ldc;
+            for (int j = 0; j < N; ++j) c[j] = scale * (float)acc[j];
+        }
+    });
+}
+
+// ── Blocked transpose ─────────────────────────────────────────────────────────
+// Cache-oblivious: split the longer side in half until the tile fits in
+// L1, then copy it with a plain double loop. Each tile reads TILE source
+// rows and writes TILE destination rows, so neither side thrashes.
+static constexpr int64_t TRANSPOSE_TILE  = 32;
+static constexpr int64_t TRANSPOSE_GRAIN = 1 << 16;   // elements per thread
+
+template <typename T>
+static void transposeRec(int64_t r0, int64_t r1, int64_t c0, int64_t c1,
+                         const T* src, std::ptrdiff_t lds, T* dst, std::ptrdiff_t ldd) {
+    while (r1 - r0 > TRANSPOSE_TILE || c1 - c0 > TRANSPOSE_TILE) {
+        if (r1 - r0 >= c1 - c0) {
+            int64_t rm = r0 + (r1 - r0) / 2;
+            transposeRec(r0, rm, c0, c1, src, lds, dst, ldd);
+            r0 = rm;
+        } else {
+            int64_t cm = c0 + (c1 - c0) / 2;
+            transposeRec(r0, r1, c0, cm, src, lds, dst, ldd);
+            c0 = cm;
+        }
+    }
+    for (int64_t i = r0; i < r1; ++i) {
+        const T* s = src + i * lds;
+        for (int64_t j = c0; j < c1; ++j) dst[j * ldd + i] = s[j];
+    }
+}
+
+template <typename T>
+static void transposeTyped(int64_t rows, int64_t cols, const T* src, std::ptrdiff_t lds,
+                           T* dst, std::ptrdiff_t ldd) {
+    // stripes of whole tiles, so threads never share a destination cache line
+    int64_t tiles = (rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    int64_t grain = std::max<int64_t>(1, TRANSPOSE_GRAIN / std::max<int64_t>(cols * TRANSPOSE_TILE, 1));
+    parallel_for(tiles, grain, [&](int64_t b, int64_t e, int) {
+        transposeRec(b * TRANSPOSE_TILE, std::min(rows, e * TRANSPOSE_TILE), 0, cols, src, lds, dst, ldd);
+    });
+}
+
+void transpose(int64_t rows, int64_t cols,
+               const void* src, std::ptrdiff_t lds,
+               void*       dst, std::ptrdiff_t ldd, size_t elemSize) {
+    if (rows <= 0 || cols <= 0) return;
+    switch (elemSize) {
+    case 1:  transposeTyped(rows, cols, static_cast<const uint8_t*>(src),  lds, static_cast<uint8_t*>(dst),  ldd); break;
+    case 2:  transposeTyped(rows, cols, static_cast<const uint16_t*>(src), lds, static_cast<uint16_t*>(dst), ldd); break;
+    default: transposeTyped(rows, cols, static_cast<const uint32_t*>(src), lds, static_cast<uint32_t*>(dst), ldd); break;
+    }
+}
+
+} // namespace nexa
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace nexa {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Single-precision GEMM engine used by nexa::matmul / ai_matmul.
+//
+//   C[M x N] = A[M x K] * B[K x N]        (all row-major, C is overwritten)
+//
+// lda / ldb / ldc are row strides in elements, so sub-matrices of a larger
+// buffer can be passed without copying.
+//
+// Layout follows the classic Goto/BLIS scheme:
+//   • B is packed into KC x NC panels (NR columns wide)   → stays in L2/L3
+//   • A is packed into MC x KC panels (MR rows tall)      → stays in L2
+//   • an MR x NR register-blocked micro-kernel streams both panels from L1
+// The micro-kernel is AVX2/FMA when the CPU supports it (checked once at
+// runtime) and a portable auto-vectorisable C++ loop otherwise.
+// ─────────────────────────────────────────────────────────────────────────────
+void sgemm(int M, int N, int K,
+           const float* A, std::ptrdiff_t lda,
+           const float* B, std::ptrdiff_t ldb,
+           float*       C, std::ptrdiff_t ldc);
+
+// C = op(A) * op(B), where op(X) is X or Xᵀ. op(A) is M x K and op(B) is
+// K x N; a transposed operand is stored the other way round (A as K x M,
+// B as N x K, row-major with row stride lda / ldb). The transpose is folded
+// into the packing step, so e.g. Xᵀ * X never materialises Xᵀ.
+enum class Transpose { No, Yes };
+void sgemm(Transpose ta, Transpose tb, int M, int N, int K,
+           const float* A, std::ptrdiff_t lda,
+           const float* B, std::ptrdiff_t ldb,
+           float*       C, std::ptrdiff_t ldc);
+
+// Batched GEMM: C[i] = A[i] * B[i] for i in [0, batch), every problem the
+// same M x N x K with the same leading dimensions. Entries may repeat (a
+// broadcast operand passes the same pointer for every batch index).
+// When B is shared and the A / C slices are stacked back to back, the whole
+// batch runs as one tall GEMM; otherwise small problems are spread across
+// threads one matrix each and large ones use the threaded engine in turn.
+void sgemm_batched(int batch, int M, int N, int K,
+                   const float* const* A, std::ptrdiff_t lda,
+                   const float* const* B, std::ptrdiff_t ldb,
+                   float* const*       C, std::ptrdiff_t ldc);
+
+// Quantised GEMM for int8 tensors (value = (q - zero) * scale):
+//   C[M x N] = scale * Σ_k (A[i][k] - za) * (B[k][j] - zb)
+// with exact int32 accumulation; scale is the product of both operand
+// scales. B is repacked as int16 pairs so the AVX2 kernel can use
+// vpmaddwd (16 multiply-adds per instruction). Exact while K < 32768.
+void qgemm_s8(int M, int N, int K,
+              const int8_t* A, std::ptrdiff_t lda, int32_t za,
+              const int8_t* B, std::ptrdiff_t ldb, int32_t zb,
+              float scale, float* C, std::ptrdiff_t ldc);
+
+// dst[cols x rows] = src[rows x cols]ᵀ for elements of elemSize bytes
+// (1, 2 or 4), with row strides lds / ldd in elements. Recursively halves
+// the longer side down to cache-sized tiles, so both the reads and the
+// writes stay in cache whatever the shape; large inputs are split across
+// threads by row stripes.
+void transpose(int64_t rows, int64_t cols,
+               const void* src, std::ptrdiff_t lds,
+               void*       dst, std::ptrdiff_t ldd, size_t elemSize);
+
+// Name of the micro-kernel selected for this CPU ("avx2-fma" / "generic").
+const char* sgemm_kernel_name();
+
+} // namespace nexa
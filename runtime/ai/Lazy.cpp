@@ -0,0 +1,326 @@
+#include "Lazy.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+extern "C" {
+int nexa_lazy_pending = 0;
+}
+
+namespace nexa {
+
+namespace {
+
+constexpr int64_t LAZY_BLOCK     = 512;        // elements per evaluation block
+constexpr int64_t LAZY_GRAIN     = 1 << 15;    // elements per thread
+constexpr int     MAX_LAZY_NODES = 32;         // longer chains are evaluated in pieces
+
+// ── Mode and the pending-tensor registry ─────────────────────────────────────
+
+std::atomic<int> lazyMode{-1};                 // -1: not read from NEXA_LAZY yet
+
+std::mutex           registryMutex;
+std::vector<Tensor*> registry;                 // every pending tensor handle
+
+void track(Tensor* t) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.push_back(t);
+    nexa_lazy_pending = (int)registry.size();
+}
+
+// ── Building expressions ──────────────────────────────────────────────────────
+
+std::shared_ptr<const LazyExpr> exprOf(Tensor* t) {
+    if (t->pending) return t->pending;
+    auto e = std::make_shared<LazyExpr>();
+    e->leaf  = t;
+    e->shape = t->shape;
+    ai_retain(t);
+    return e;
+}
+
+Tensor* makePending(std::shared_ptr<LazyExpr> e) {
+    auto* t    = new Tensor();
+    t->shape   = e->shape;
+    t->strides = Tensor::denseStrides(t->shape);
+    t->pending = std::move(e);
+    t->syncHeader();
+    track(t);
+    return t;
+}
+
+// ── Compiled program ──────────────────────────────────────────────────────────
+// The DAG flattened into steps in dependency order; step k writes slot k.
+// Leaves are aligned to the output shape (stride 0 along broadcast
+// dimensions). When every leaf is either dense with the output's shape or a
+// single value, the output is walked as one flat range; otherwise row by row.
+
+struct Leaf {
+    const void*          base;
+    DType                dtype;
+    QuantParams          quant;
+    size_t               size;                 // bytes per element
+    std::vector<int64_t> strides;              // aligned to the output, nd entries
+    bool                 dense, single;
+};
+
+struct Step {
+    LazyOp op;
+    int    a = -1, b = -1, leaf = -1;
+    float  scalar = 0.f;
+    bool   scalarLeft = false;
+};
+
+struct Program {
+    std::vector<int>  shape;                   // output shape, padded to >= 2 dims
+    int64_t           rows = 0, cols = 0;
+    bool              flat = true;
+    std::vector<Leaf> leaves;
+    std::vector<Step> steps;
+};
+
+int compile(const LazyExpr* e, Program& p, std::unordered_map<const void*, int>& seen) {
+    const void* key = e->op == LazyOp::Leaf ? (const void*)e->leaf : (const void*)e;
+    if (auto it = seen.find(key); it != seen.end()) return it->second;
+    Step s;
+    s.op = e->op;
+    if (e->op == LazyOp::Leaf) {
+        const Tensor& t = *e->leaf;
+        int nd = (int)p.shape.size();
+        Leaf l{t.raw(), t.dtype, t.quant, dtypeSize(t.dtype), std::vector<int64_t>(nd, 0), false, false};
+        for (int d = 0, k = nd - t.ndim(); d < t.ndim(); ++d)
+            l.strides[k + d] = t.shape[d] == 1 ? 0 : t.strides[d];
+        size_t total = 1;
+        for (int d : p.shape) total *= (size_t)d;
+        l.single = t.numel() == 1;
+        l.dense  = t.numel() == total && t.isContiguous();
+        p.flat  &= l.single || l.dense;
+        s.leaf = (int)p.leaves.size();
+        p.leaves.push_back(std::move(l));
+    } else {
+        s.a = compile(e->a.get(), p, seen);
+        if (e->b) s.b = compile(e->b.get(), p, seen);
+        s.scalar     = e->scalar;
+        s.scalarLeft = e->scalarLeft;
+    }
+    p.steps.push_back(s);
+    return seen[key] = (int)p.steps.size() - 1;
+}
+
+Program compileProgram(const Tensor& t) {
+    Program p;
+    p.shape = t.shape;
+    while (p.shape.size() < 2) p.shape.insert(p.shape.begin(), 1);
+    int nd = (int)p.shape.size();
+    p.cols = p.shape[nd - 1];
+    p.rows = 1;
+    for (int d = 0; d < nd - 1; ++d) p.rows *= p.shape[d];
+    std::unordered_map<const void*, int> seen;
+    compile(t.pending.get(), p, seen);
+    return p;
+}
+
+// ── Block evaluation ──────────────────────────────────────────────────────────
+
+// Offset of output row `row` inside a leaf, from its aligned strides
+int64_t rowOffset(const Program& p, const Leaf& l, int64_t row) {
+    int64_t off = 0;
+    for (int d = (int)p.shape.size() - 2; d >= 0 && row; --d) {
+        off += (row % p.shape[d]) * l.strides[d];
+        row /= p.shape[d];
+    }
+    return off;
+}
+
+// n values of a leaf starting at element `off`, `cs` apart: a pointer into
+// the tensor when it is f32 and unit-stride, else decoded into buf.
+const float* loadLeaf(const Leaf& l, int64_t off, int64_t cs, int64_t n, float* buf) {
+    bool f32 = l.dtype == DType::F32;
+    const float* f = static_cast<const float*>(l.base);
+    if (cs == 1) {
+        if (f32) return f + off;
+        decode(l.dtype, static_cast<const char*>(l.base) + off * (int64_t)l.size, n, buf, l.quant);
+    } else if (cs == 0) {
+        std::fill(buf, buf + n, f32 ? f[off] : decodeOne(l.dtype, l.base, off, l.quant));
+    } else {
+        for (int64_t k = 0; k < n; ++k)
+            buf[k] = f32 ? f[off + k * cs] : decodeOne(l.dtype, l.base, off + k * cs, l.quant);
+    }
+    return buf;
+}
+
+template <typename F>
+void apply(const Step& s, const float* __restrict a, const float* __restrict b,
+           float* __restrict o, int64_t n, F f) {
+    if (b) {
+        for (int64_t k = 0; k < n; ++k) o[k] = f(a[k], b[k]);
+    } else if (s.scalarLeft) {
+        const float v = s.scalar;
+        for (int64_t k = 0; k < n; ++k) o[k] = f(v, a[k]);
+    } else {
+        const float v = s.scalar;
+        for (int64_t k = 0; k < n; ++k) o[k] = f(a[k], v);
+    }
+}
+
+// Evaluate n output elements: output row `row` from column `col`, or flat
+// elements [col, col + n) when row < 0. Slot k lives at scratch + k*LAZY_BLOCK;
+// the last step writes into dst instead when one is given.
+const float* evalBlock(const Program& p, int64_t row, int64_t col, int64_t n,
+                       float* scratch, const float** val, float* dst) {
+    size_t last = p.steps.size() - 1;
+    for (size_t k = 0; k <= last; ++k) {
+        const Step& s = p.steps[k];
+        float* buf = k == last && dst ? dst : scratch + k * LAZY_BLOCK;
+        if (s.op == LazyOp::Leaf) {
+            const Leaf& l = p.leaves[s.leaf];
+            if (row < 0) val[k] = loadLeaf(l, l.single ? 0 : col, l.single ? 0 : 1, n, buf);
+            else         val[k] = loadLeaf(l, rowOffset(p, l, row) + col * l.strides.back(), l.strides.back(), n, buf);
+            if (k == last && dst && val[k] != buf) std::copy(val[k], val[k] + n, buf);
+            continue;
+        }
+        const float* a = val[s.a];
+        const float* b = s.b >= 0 ? val[s.b] : nullptr;
+        switch (s.op) {
+        case LazyOp::Add: apply(s, a, b, buf, n, [](float x, float y) { return x + y; }); break;
+        case LazyOp::Sub: apply(s, a, b, buf, n, [](float x, float y) { return x - y; }); break;
+        case LazyOp::Mul: apply(s, a, b, buf, n, [](float x, float y) { return x * y; }); break;
+        case LazyOp::Div: apply(s, a, b, buf, n, [](float x, float y) { return x / y; }); break;
+        case LazyOp::Leaf: break;
+        }
+        val[k] = buf;
+    }
+    return dst ? dst : val[last];
+}
+
+int64_t rowGrain(const Program& p) { return std::max<int64_t>(1, LAZY_GRAIN / std::max<int64_t>(p.cols, 1)); }
+
+// Walk the whole output; with dst the result is written there (dense),
+// otherwise each block is handed to fn.
+void run(const Program& p, float* dst, const LazyBlockFn* fn) {
+    int64_t total = p.rows * p.cols;
+    if (total == 0) return;
+    auto body = [&](int64_t row, int64_t col, int64_t start, int64_t n,
+                    float* scratch, const float** val, int chunk) {
+        const float* x = evalBlock(p, row, col, n, scratch, val, dst ? dst + start : nullptr);
+        if (fn) (*fn)(start, x, n, chunk);
+    };
+    size_t slots = p.steps.size();
+    if (p.flat) {
+        parallel_for(total, LAZY_GRAIN, [&](int64_t b, int64_t e, int chunk) {
+            std::vector<float> scratch(slots * LAZY_BLOCK);
+            std::vector<const float*> val(slots);
+            for (int64_t s = b; s < e; s += LAZY_BLOCK)
+                body(-1, s, s, std::min(LAZY_BLOCK, e - s), scratch.data(), val.data(), chunk);
+        });
+        return;
+    }
+    parallel_for(p.rows, rowGrain(p), [&](int64_t b, int64_t e, int chunk) {
+        std::vector<float> scratch(slots * LAZY_BLOCK);
+        std::vector<const float*> val(slots);
+        for (int64_t i = b; i < e; ++i)
+            for (int64_t j = 0; j < p.cols; j += LAZY_BLOCK)
+                body(i, j, i * p.cols + j, std::min(LAZY_BLOCK, p.cols - j), scratch.data(), val.data(), chunk);
+    });
+}
+
+} // namespace
+
+LazyExpr::~LazyExpr() { ai_release(leaf); }
+
+bool lazyEnabled() {
+    int m = lazyMode.load(std::memory_order_relaxed);
+    if (m < 0) {
+        const char* env = std::getenv("NEXA_LAZY");
+        m = env && *env && *env != '0';
+        lazyMode.store(m, std::memory_order_relaxed);
+    }
+    return m != 0;
+}
+
+void setLazy(bool on) {
+    lazyMode.store(on, std::memory_order_relaxed);
+    if (!on) nexa_lazy_flush();
+}
+
+Tensor* lazyBinary(LazyOp op, Tensor* a, Tensor* b, const std::vector<int>& shape) {
+    auto ea = exprOf(a), eb = exprOf(b);
+    if (ea->nodes + eb->nodes >= MAX_LAZY_NODES) {
+        // cap the expression size: evaluate the pending operands now
+        if (a->pending) { materialize(*a); ea = exprOf(a); }
+        if (b->pending) { materialize(*b); eb = exprOf(b); }
+    }
+    auto e = std::make_shared<LazyExpr>();
+    e->op    = op;
+    e->shape = shape;
+    e->nodes = ea->nodes + eb->nodes + 1;
+    e->a     = std::move(ea);
+    e->b     = std::move(eb);
+    return makePending(std::move(e));
+}
+
+Tensor* lazyScalar(LazyOp op, Tensor* t, float s, bool scalarLeft) {
+    auto ea = exprOf(t);
+    if (ea->nodes >= MAX_LAZY_NODES) { materialize(*t); ea = exprOf(t); }
+    auto e = std::make_shared<LazyExpr>();
+    e->op         = op;
+    e->shape      = t->shape;
+    e->nodes      = ea->nodes + 1;
+    e->scalar     = s;
+    e->scalarLeft = scalarLeft;
+    e->a          = std::move(ea);
+    return makePending(std::move(e));
+}
+
+int lazyChunks(const Tensor& t) {
+    Program p = compileProgram(t);
+    return p.flat ? parallel_chunks(p.rows * p.cols, LAZY_GRAIN) : parallel_chunks(p.rows, rowGrain(p));
+}
+
+void lazyForEachBlock(const Tensor& t, const LazyBlockFn& fn) {
+    run(compileProgram(t), nullptr, &fn);
+}
+
+void materialize(Tensor& t) {
+    if (!t.pending) return;
+    FloatBuffer out(t.numel());
+    run(compileProgram(t), out.data(), nullptr);
+    forgetPending(&t);
+    t.pending.reset();                          // drops the references to the leaves
+    t.storage = std::make_shared<FloatBuffer>(std::move(out));
+    t.packed.reset();
+    t.dtype   = DType::F32;
+    t.offset  = 0;
+    t.strides = Tensor::denseStrides(t.shape);
+    t.syncHeader();
+}
+
+void forgetPending(Tensor* t) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = std::find(registry.begin(), registry.end(), t);
+    if (it != registry.end()) registry.erase(it);
+    nexa_lazy_pending = (int)registry.size();
+}
+
+} // namespace nexa
+
+extern "C" {
+
+void nexa_set_lazy(int on) { nexa::setLazy(on != 0); }
+
+void nexa_lazy_flush() {
+    for (;;) {
+        nexa::Tensor* t;
+        {
+            std::lock_guard<std::mutex> lock(nexa::registryMutex);
+            if (nexa::registry.empty()) return;
+            t = nexa::registry.back();
+        }
+        nexa::materialize(*t);
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,80 @@
+#pragma once
+#include "Tensor.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace nexa {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Lazy mode: deferred element-wise expressions.
+//
+// Off by default; NEXA_LAZY=1 or set_lazy(1) turns it on. In lazy mode
+// + - * / between tensors, and between a tensor and a scalar, compute
+// nothing: they return a *pending* tensor that has its shape but no
+// elements, plus the expression that produces them. A pending operand is
+// inlined into the new expression, so a chain of ops becomes one small DAG
+// whose leaves are ordinary tensors.
+//
+// The expression runs when a value is observed:
+//   • sum / mean / max / min stream it straight into the reduction, so
+//     sum((a - b) * (a - b)) is one pass over a and b and allocates nothing;
+//   • any other runtime function (print, get_value, matmul, csv_write, …)
+//     materialises it once, in place — the handle then behaves like any
+//     other tensor.
+// Evaluation walks the output in blocks of a few hundred elements and
+// computes each DAG node once per block into a per-thread buffer, so a
+// shared subexpression is not recomputed and intermediates never reach
+// memory. Leaves are read at their own dtype and strides, broadcasting
+// included.
+//
+// Pending tensors read their inputs when they are evaluated, so every write
+// into a tensor (set_value / csv_set, inline or through the runtime) first
+// evaluates all pending tensors — see nexa_lazy_flush().
+// ─────────────────────────────────────────────────────────────────────────────
+
+enum class LazyOp : uint8_t { Leaf, Add, Sub, Mul, Div };
+
+struct LazyExpr {
+    LazyOp                          op = LazyOp::Leaf;
+    std::shared_ptr<const LazyExpr> a, b;            // b == nullptr: op with `scalar`
+    float                           scalar = 0.f;
+    bool                            scalarLeft = false;
+    Tensor*                         leaf = nullptr;  // Leaf only; holds a reference
+    std::vector<int>                shape;           // result shape
+    int                             nodes = 1;       // size of the expression tree
+
+    ~LazyExpr();
+};
+
+bool lazyEnabled();
+void setLazy(bool on);
+
+// Pending a op b (shape is the already-checked broadcast shape) and t op s
+// (s op t when scalarLeft). Operands are retained, not copied.
+Tensor* lazyBinary(LazyOp op, Tensor* a, Tensor* b, const std::vector<int>& shape);
+Tensor* lazyScalar(LazyOp op, Tensor* t, float s, bool scalarLeft);
+
+// Evaluate a pending tensor block by block without storing it: fn gets the
+// row-major index of the block's first element, the values and the chunk
+// (0 .. lazyChunks(t) - 1) of the parallel_for running it. Blocks within a
+// chunk arrive in order.
+using LazyBlockFn = std::function<void(int64_t start, const float* block, int64_t n, int chunk)>;
+int  lazyChunks(const Tensor& t);
+void lazyForEachBlock(const Tensor& t, const LazyBlockFn& fn);
+
+} // namespace nexa
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LLVM Bridge
+// ─────────────────────────────────────────────────────────────────────────────
+extern "C" {
+
+void nexa_set_lazy(int on);
+// Number of pending tensors; generated code checks it before inline stores
+// and calls nexa_lazy_flush() (evaluate them all) when it is non-zero.
+extern int nexa_lazy_pending;
+void nexa_lazy_flush();
+
+} // extern "C"
@@ -0,0 +1,166 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nexa {
+
+// ── Thread count ──────────────────────────────────────────────────────────────
+
+static int defaultThreadCount() {
+    if (const char* env = std::getenv("NEXA_NUM_THREADS")) {
+        int n = std::atoi(env);
+        if (n > 0) return n;
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? (int)hw : 1;
+}
+
+static std::atomic<int>& threadCount() {
+    static std::atomic<int> n{defaultThreadCount()};
+    return n;
+}
+
+// Set while a thread is executing a chunk, so nested parallel_for calls
+// (e.g. a kernel calling sgemm) run inline instead of deadlocking the pool.
+static thread_local bool inParallelRegion = false;
+
+// ── Pool ──────────────────────────────────────────────────────────────────────
+// Workers sleep on a condition variable between jobs. A job is a chunk count
+// plus a callback; workers and the caller pull chunk indices from the job's
+// own atomic counter until none are left. Each worker takes its reference to
+// the job under the mutex, so one that wakes late can only ever claim from
+// the job it saw — by then an exhausted counter — never from the next one.
+namespace {
+class ThreadPool {
+public:
+    explicit ThreadPool(int workers) {
+        for (int i = 0; i < workers; ++i)
+            threads.emplace_back([this] { workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    int size() const { return (int)threads.size(); }
+
+    void run(int chunks, const std::function<void(int)>& fn) {
+        auto job = std::make_shared<Job>(fn, chunks);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = job;
+            ++generation;
+        }
+        wake.notify_all();
+        drain(*job);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return job->remaining == 0; });
+        current.reset();
+    }
+
+private:
+    struct Job {
+        const std::function<void(int)>& fn;
+        const int                       chunks;
+        std::atomic<int>                next{0};
+        int                             remaining;     // guarded by the pool mutex
+
+        Job(const std::function<void(int)>& f, int n) : fn(f), chunks(n), remaining(n) {}
+    };
+
+    std::vector<std::thread>  threads;
+    std::mutex                mutex;
+    std::condition_variable   wake, done;
+    std::shared_ptr<Job>      current;
+    uint64_t                  generation = 0;
+    bool                      stopping = false;
+
+    void drain(Job& job) {
+        int finished = 0;
+        for (int c; (c = job.next.fetch_add(1)) < job.chunks; ++finished) {
+            inParallelRegion = true;
+            job.fn(c);
+            inParallelRegion = false;
+        }
+        if (finished) {
+            std::lock_guard<std::mutex> lock(mutex);
+            job.remaining -= finished;
+            if (job.remaining == 0) done.notify_all();
+        }
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                job  = current;
+            }
+            if (job) drain(*job);
+        }
+    }
+};
+} // namespace
+
+static std::mutex                  poolMutex;   // one job in flight at a time
+static std::unique_ptr<ThreadPool> pool;
+
+int num_threads() { return threadCount().load(); }
+
+void set_num_threads(int n) {
+    if (n < 1) n = defaultThreadCount();
+    std::lock_guard<std::mutex> lock(poolMutex);
+    threadCount().store(n);
+    if (pool && pool->size() != n - 1) pool.reset();
+}
+
+int parallel_chunks(int64_t n, int64_t grain) {
+    if (n <= 0) return 0;
+    if (grain < 1) grain = 1;
+    int64_t byGrain = (n + grain - 1) / grain;
+    return (int)std::max<int64_t>(1, std::min<int64_t>(num_threads(), byGrain));
+}
+
+void parallel_for(int64_t n, int64_t grain, const RangeFn& fn) {
+    if (n <= 0) return;
+    int chunks = parallel_chunks(n, grain);
+    if (chunks <= 1 || inParallelRegion) { fn(0, n, 0); return; }
+
+    // Another user thread already owns the pool — don't queue behind it.
+    std::unique_lock<std::mutex> lock(poolMutex, std::try_to_lock);
+    if (!lock.owns_lock()) { fn(0, n, 0); return; }
+
+    int threads = num_threads();
+    if (!pool) pool = std::make_unique<ThreadPool>(threads - 1);
+
+    std::function<void(int)> chunkFn = [&](int c) {
+        int64_t begin = n * c / chunks;
+        int64_t end   = n * (c + 1) / chunks;
+        fn(begin, end, c);
+    };
+    pool->run(chunks, chunkFn);
+}
+
+} // namespace nexa
+
+extern "C" {
+
+void nexa_set_num_threads(int n) { nexa::set_num_threads(n); }
+int  nexa_get_num_threads()      { return nexa::num_threads(); }
+
+} // extern "C"
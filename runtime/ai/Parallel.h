@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+namespace nexa {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Runtime thread pool shared by all heavy tensor kernels.
+//
+// Thread count: NEXA_NUM_THREADS env var if set, otherwise the number of
+// hardware threads. nexa_set_num_threads() overrides it at runtime.
+// The calling thread always takes part in the work, so a count of 1 means
+// "no worker threads at all".
+// ─────────────────────────────────────────────────────────────────────────────
+
+int  num_threads();
+void set_num_threads(int n);
+
+// Split [0, n) into at most num_threads() contiguous chunks of >= grain items
+// and run fn(begin, end, chunk) on each, returning once all are done.
+// Runs inline (a single chunk 0) when n <= grain, when only one thread is
+// configured, or when called from inside another parallel_for.
+using RangeFn = std::function<void(int64_t begin, int64_t end, int chunk)>;
+void parallel_for(int64_t n, int64_t grain, const RangeFn& fn);
+
+// Number of chunks parallel_for(n, grain, ...) will use — size per-chunk
+// scratch (e.g. partial sums) with this before calling it.
+int parallel_chunks(int64_t n, int64_t grain);
+
+} // namespace nexa
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LLVM Bridge
+// ─────────────────────────────────────────────────────────────────────────────
+extern "C" {
+
+void nexa_set_num_threads(int n);
+int  nexa_get_num_threads();
+
+} // extern "C"
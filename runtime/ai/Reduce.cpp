@@ -0,0 +1,394 @@
+#include "Tensor.h"
+#include "Lazy.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define NEXA_REDUCE_X86 1
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Reductions: sum / mean / max / min over a whole tensor, and the same plus
+// argmax along one axis.
+//
+// Contiguous runs are reduced with several independent accumulators (4 ymm
+// registers on AVX2, 8 scalars otherwise) so the adds pipeline instead of
+// forming one long dependency chain. Sums are accumulated in float only
+// within a block of SUM_BLOCK elements and the block totals in double; the
+// blocked double accumulation bounds the float error to that of one block.
+//
+// max / min propagate NaN like sum does: any NaN in the input makes the
+// result NaN, whatever its position, the lane split or the kernel used.
+// argmax picks the first NaN.
+//
+// bf16 / f16 / i8 tensors are decoded SUM_BLOCK elements (or one row) at a
+// time into a small buffer and reduced in fp32, so they are read at their
+// storage width and never expanded to a full fp32 copy.
+//
+// A pending lazy tensor (Lazy.h) is reduced block by block while it is
+// evaluated, so a fused expression is never stored.
+//
+// Axis reductions make one pass over the rows in memory order:
+//   axis 0 → [1 x cols]   (each row is folded into a running column vector)
+//   axis 1 → [rows x 1]   (each row reduced on its own)
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace {
+
+constexpr int64_t SUM_BLOCK     = 4096;
+constexpr int64_t REDUCE_GRAIN  = 1 << 16;   // elements per thread
+
+// ── Contiguous kernels ────────────────────────────────────────────────────────
+
+// x replaces the running extreme m: x is larger (smaller), or x is NaN and m
+// is not yet, so a NaN sticks and the first one is kept
+template <bool Max>
+inline bool beats(float x, float m) { return m == m && (x != x || (Max ? x > m : x < m)); }
+
+double sumGeneric(const float* x, int64_t n) {
+    double total = 0;
+    for (int64_t b = 0; b < n; b += SUM_BLOCK) {
+        int64_t e = std::min(n, b + SUM_BLOCK);
+        float acc[8] = {};
+        int64_t i = b;
+        for (; i + 8 <= e; i += 8)
+            for (int k = 0; k < 8; ++k) acc[k] += x[i + k];
+        float s = ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+        for (; i < e; ++i) s += x[i];
+        total += s;
+    }
+    return total;
+}
+
+template <bool Max>
+float extremeGeneric(const float* x, int64_t n) {
+    float acc[8];
+    std::fill(acc, acc + 8, x[0]);
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        for (int k = 0; k < 8; ++k)
+            acc[k] = beats<Max>(x[i + k], acc[k]) ? x[i + k] : acc[k];
+    float m = acc[0];
+    for (int k = 1; k < 8; ++k) m = beats<Max>(acc[k], m) ? acc[k] : m;
+    for (; i < n; ++i) m = beats<Max>(x[i], m) ? x[i] : m;
+    return m;
+}
+
+#ifdef NEXA_REDUCE_X86
+__attribute__((target("avx2")))
+inline float hsumAvx2(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2")))
+double sumAvx2(const float* x, int64_t n) {
+    double total = 0;
+    for (int64_t b = 0; b < n; b += SUM_BLOCK) {
+        int64_t e = std::min(n, b + SUM_BLOCK);
+        __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+        __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+        int64_t i = b;
+        for (; i + 32 <= e; i += 32) {
+            a0 = _mm256_add_ps(a0, _mm256_loadu_ps(x + i));
+            a1 = _mm256_add_ps(a1, _mm256_loadu_ps(x + i + 8));
+            a2 = _mm256_add_ps(a2, _mm256_loadu_ps(x + i + 16));
+            a3 = _mm256_add_ps(a3, _mm256_loadu_ps(x + i + 24));
+        }
+        for (; i + 8 <= e; i += 8) a0 = _mm256_add_ps(a0, _mm256_loadu_ps(x + i));
+        float s = hsumAvx2(_mm256_add_ps(_mm256_add_ps(a0, a1), _mm256_add_ps(a2, a3)));
+        for (; i < e; ++i) s += x[i];
+        total += s;
+    }
+    return total;
+}
+
+template <bool Max>
+__attribute__((target("avx2")))
+inline __m256 pick(__m256 a, __m256 b) { return Max ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b); }
+
+// max_ps / min_ps return their second operand when either is NaN, so NaN
+// lanes are tracked in a mask on the side and decide the result at the end.
+template <bool Max>
+__attribute__((target("avx2")))
+float extremeAvx2(const float* x, int64_t n) {
+    if (n < 32) return extremeGeneric<Max>(x, n);
+    __m256 a0 = _mm256_loadu_ps(x), a1 = _mm256_loadu_ps(x + 8);
+    __m256 a2 = _mm256_loadu_ps(x + 16), a3 = _mm256_loadu_ps(x + 24);
+    __m256 nan = _mm256_or_ps(_mm256_cmp_ps(a0, a1, _CMP_UNORD_Q), _mm256_cmp_ps(a2, a3, _CMP_UNORD_Q));
+    int64_t i = 32;
+    for (; i + 32 <= n; i += 32) {
+        __m256 v0 = _mm256_loadu_ps(x + i), v1 = _mm256_loadu_ps(x + i + 8);
+        __m256 v2 = _mm256_loadu_ps(x + i + 16), v3 = _mm256_loadu_ps(x + i + 24);
+        nan = _mm256_or_ps(nan, _mm256_or_ps(_mm256_cmp_ps(v0, v1, _CMP_UNORD_Q), _mm256_cmp_ps(v2, v3, _CMP_UNORD_Q)));
+        a0 = pick<Max>(a0, v0);
+        a1 = pick<Max>(a1, v1);
+        a2 = pick<Max>(a2, v2);
+        a3 = pick<Max>(a3, v3);
+    }
+    // the first NaN, as the scalar kernel returns it
+    if (_mm256_movemask_ps(nan))
+        for (int64_t k = 0; k < i; ++k)
+            if (x[k] != x[k]) return x[k];
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, pick<Max>(pick<Max>(a0, a1), pick<Max>(a2, a3)));
+    float m = extremeGeneric<Max>(lanes, 8);
+    for (; i < n; ++i) m = beats<Max>(x[i], m) ? x[i] : m;
+    return m;
+}
+#endif
+
+struct Kernels {
+    double (*sum)(const float*, int64_t);
+    float  (*max)(const float*, int64_t);
+    float  (*min)(const float*, int64_t);
+};
+
+const Kernels& kernels() {
+    static const Kernels k = [] {
+#ifdef NEXA_REDUCE_X86
+        if (__builtin_cpu_supports("avx2"))
+            return Kernels{sumAvx2, extremeAvx2<true>, extremeAvx2<false>};
+#endif
+        return Kernels{sumGeneric, extremeGeneric<true>, extremeGeneric<false>};
+    }();
+    return k;
+}
+
+// ── Whole-tensor reductions ───────────────────────────────────────────────────
+// A tensor is reduced as `rows` runs of `cols` floats, `ld` apart; a dense
+// tensor is a single run. Large inputs are split across threads by runs (or
+// by element range for a single run) and the partials combined.
+
+struct Runs {
+    const void*       base;             // element 0, stored as dtype
+    int64_t           rows, cols, ld;
+    nexa::DType       dtype;
+    nexa::QuantParams quant;
+};
+
+Runs runsOf(const nexa::Tensor& t, nexa::FloatBuffer& scratch) {
+    int64_t rows = t.rows, cols = t.cols, ld;
+    const void* p;
+    nexa::DType dtype = nexa::DType::F32;
+    if (t.dtype != nexa::DType::F32 && t.unitColumns()) {
+        p = t.raw();
+        ld = rows > 1 ? t.rowStride : cols;
+        dtype = t.dtype;
+    } else {
+        p = t.rowMajorData(scratch, ld);
+    }
+    if (ld == cols || rows <= 1) return {p, 1, rows * cols, cols, dtype, t.quant};
+    return {p, rows, cols, ld, dtype, t.quant};
+}
+
+// run() over elements [start, start + n) of r; n > 0
+template <typename T, typename Run, typename Join>
+T runAt(const Runs& r, int64_t start, int64_t n, Run run, Join join) {
+    if (r.dtype == nexa::DType::F32) return run(static_cast<const float*>(r.base) + start, n);
+    const size_t sz = nexa::dtypeSize(r.dtype);
+    const char*  p  = static_cast<const char*>(r.base) + start * (int64_t)sz;
+    float buf[SUM_BLOCK];
+    T acc{};
+    for (int64_t b = 0; b < n; b += SUM_BLOCK) {
+        int64_t m = std::min(SUM_BLOCK, n - b);
+        nexa::decode(r.dtype, p + b * (int64_t)sz, m, buf, r.quant);
+        acc = b == 0 ? run(buf, m) : join(acc, run(buf, m));
+    }
+    return acc;
+}
+
+// run(ptr, n) reduces one contiguous run; join folds two partial results.
+// parallel_for may run fewer chunks than planned (nested calls run inline as
+// chunk 0), so only the partials that were actually written are joined.
+template <typename T, typename Run, typename Join>
+T reduceRuns(const Runs& r, Run run, Join join) {
+    bool    single = r.rows == 1;
+    int64_t n      = single ? r.cols : r.rows;
+    int64_t grain  = single ? REDUCE_GRAIN
+                            : std::max<int64_t>(1, REDUCE_GRAIN / std::max<int64_t>(r.cols, 1));
+    int chunks = nexa::parallel_chunks(n, grain);
+    std::vector<T>    part(std::max(chunks, 1));
+    std::vector<char> filled(part.size(), 0);
+    nexa::parallel_for(n, grain, [&](int64_t b, int64_t e, int c) {
+        if (single) {
+            part[c] = runAt<T>(r, b, e - b, run, join);
+        } else {
+            T acc = runAt<T>(r, b * r.ld, r.cols, run, join);
+            for (int64_t i = b + 1; i < e; ++i) acc = join(acc, runAt<T>(r, i * r.ld, r.cols, run, join));
+            part[c] = acc;
+        }
+        filled[c] = 1;
+    });
+    T result = part[0];
+    for (int c = 1; c < chunks; ++c) if (filled[c]) result = join(result, part[c]);
+    return result;
+}
+
+// The same for a pending tensor: each evaluated block is one run.
+template <typename T, typename Run, typename Join>
+T reducePending(const nexa::Tensor& t, Run run, Join join) {
+    int chunks = std::max(nexa::lazyChunks(t), 1);
+    std::vector<T>    part(chunks);
+    std::vector<char> filled(chunks, 0);
+    nexa::lazyForEachBlock(t, [&](int64_t, const float* x, int64_t n, int c) {
+        T v = run(x, n);
+        part[c] = filled[c] ? join(part[c], v) : v;
+        filled[c] = 1;
+    });
+    T result = part[0];
+    for (int c = 1; c < chunks; ++c) if (filled[c]) result = join(result, part[c]);
+    return result;
+}
+
+double sumOf(const nexa::Tensor& t) {
+    if (t.numel() == 0) return 0;
+    auto sum  = kernels().sum;
+    auto join = [](double a, double b) { return a + b; };
+    if (t.pending) return reducePending<double>(t, sum, join);
+    nexa::FloatBuffer scratch;
+    return reduceRuns<double>(runsOf(t, scratch), sum, join);
+}
+
+template <bool Max>
+float extremeOf(const nexa::Tensor& t) {
+    if (t.numel() == 0) return 0;
+    auto fn   = Max ? kernels().max : kernels().min;
+    auto join = [](float a, float b) { return beats<Max>(b, a) ? b : a; };
+    if (t.pending) return reducePending<float>(t, fn, join);
+    nexa::FloatBuffer scratch;
+    return reduceRuns<float>(runsOf(t, scratch), fn, join);
+}
+
+// ── Axis reductions ───────────────────────────────────────────────────────────
+
+enum class Op { Sum, Mean, Max, Min, ArgMax };
+
+bool checkAxis(const char* name, int axis) {
+    if (axis == 0 || axis == 1) return true;
+    fprintf(stderr, "[nexa] %s: axis must be 0 or 1, got %d\n", name, axis);
+    return false;
+}
+
+// axis 0: fold every row into per-column accumulators. Rows are split across
+// threads, each with its own accumulator row, merged at the end.
+void* reduceRows(const nexa::Tensor& t, Op op) {
+    int rows = (int)t.rows, cols = (int)t.cols;
+    auto* out = new nexa::Tensor(nexa::FloatBuffer((size_t)cols, 0.f), {1, cols});
+    if (rows == 0 || cols == 0) return out;
+
+    int64_t grain = std::max<int64_t>(1, REDUCE_GRAIN / cols);
+    int chunks = nexa::parallel_chunks(rows, grain);
+    float* o = out->data();
+
+    if (op == Op::Sum || op == Op::Mean) {
+        std::vector<double> acc((size_t)std::max(chunks, 1) * cols, 0.0);
+        nexa::parallel_for(rows, grain, [&](int64_t b, int64_t e, int c) {
+            double* a = &acc[(size_t)c * cols];
+            std::vector<float> buf(cols);
+            for (int64_t i = b; i < e; ++i) {
+                const float* r = t.rowData(i, buf.data());
+                for (int j = 0; j < cols; ++j) a[j] += r[j];
+            }
+        });
+        double scale = op == Op::Mean ? 1.0 / rows : 1.0;
+        for (int j = 0; j < cols; ++j) {
+            double s = 0;
+            for (int c = 0; c < chunks; ++c) s += acc[(size_t)c * cols + j];
+            o[j] = (float)(s * scale);
+        }
+        return out;
+    }
+
+    // Max / Min / ArgMax: best value (and row index) per column
+    bool wantMax = op != Op::Min;
+    std::vector<float> best((size_t)std::max(chunks, 1) * cols);
+    std::vector<int>   where((size_t)std::max(chunks, 1) * cols);
+    std::vector<char>  filled(std::max(chunks, 1), 0);
+    nexa::parallel_for(rows, grain, [&](int64_t b, int64_t e, int c) {
+        filled[c] = 1;
+        float* v = &best[(size_t)c * cols];
+        int*   w = &where[(size_t)c * cols];
+        std::vector<float> buf(cols);
+        const float* first = t.rowData(b, buf.data());
+        std::copy(first, first + cols, v);
+        std::fill(w, w + cols, (int)b);
+        for (int64_t i = b + 1; i < e; ++i) {
+            const float* r = t.rowData(i, buf.data());
+            if (wantMax) { for (int j = 0; j < cols; ++j) if (beats<true>(r[j], v[j]))  { v[j] = r[j]; w[j] = (int)i; } }
+            else         { for (int j = 0; j < cols; ++j) if (beats<false>(r[j], v[j])) { v[j] = r[j]; w[j] = (int)i; } }
+        }
+    });
+    for (int j = 0; j < cols; ++j) {
+        float v = best[j];
+        int   w = where[j];
+        for (int c = 1; c < chunks; ++c) {            // chunks are in row order: ties keep the first row
+            if (!filled[c]) continue;
+            float cv = best[(size_t)c * cols + j];
+            if (wantMax ? beats<true>(cv, v) : beats<false>(cv, v)) { v = cv; w = where[(size_t)c * cols + j]; }
+        }
+        o[j] = op == Op::ArgMax ? (float)w : v;
+    }
+    return out;
+}
+
+// axis 1: each row is an independent contiguous run.
+void* reduceCols(const nexa::Tensor& t, Op op) {
+    int rows = (int)t.rows, cols = (int)t.cols;
+    auto* out = new nexa::Tensor(nexa::FloatBuffer((size_t)rows, 0.f), {rows, 1});
+    if (rows == 0 || cols == 0) return out;
+
+    const Kernels& k = kernels();
+    float* o = out->data();
+    nexa::parallel_for(rows, std::max<int64_t>(1, REDUCE_GRAIN / cols), [&](int64_t b, int64_t e, int) {
+        std::vector<float> buf(cols);
+        for (int64_t i = b; i < e; ++i) {
+            const float* r = t.rowData(i, buf.data());
+            switch (op) {
+            case Op::Sum:  o[i] = (float)k.sum(r, cols);          break;
+            case Op::Mean: o[i] = (float)(k.sum(r, cols) / cols); break;
+            case Op::Max:  o[i] = k.max(r, cols);                 break;
+            case Op::Min:  o[i] = k.min(r, cols);                 break;
+            case Op::ArgMax: {
+                int w = 0;
+                for (int j = 1; j < cols; ++j) if (beats<true>(r[j], r[w])) w = j;
+                o[i] = (float)w;
+                break;
+            }
+            }
+        }
+    });
+    return out;
+}
+
+void* reduceAxis(const char* name, void* p, int axis, Op op) {
+    if (!checkAxis(name, axis)) return nullptr;
+    auto* t = nexa::tensorArg(p);
+    return axis == 0 ? reduceRows(*t, op) : reduceCols(*t, op);
+}
+
+} // namespace
+
+extern "C" {
+
+float ai_sum(void* p)  { return (float)sumOf(*static_cast<nexa::Tensor*>(p)); }
+float ai_mean(void* p) {
+    auto* t = static_cast<nexa::Tensor*>(p);
+    size_t n = t->numel();
+    return n ? (float)(sumOf(*t) / n) : 0.f;
+}
+float ai_max(void* p)  { return extremeOf<true>(*static_cast<nexa::Tensor*>(p)); }
+float ai_min(void* p)  { return extremeOf<false>(*static_cast<nexa::Tensor*>(p)); }
+
+void* ai_sum_axis (void* p, int axis) { return reduceAxis("sum",    p, axis, Op::Sum);    }
+void* ai_mean_axis(void* p, int axis) { return reduceAxis("mean",   p, axis, Op::Mean);   }
+void* ai_max_axis (void* p, int axis) { return reduceAxis("max",    p, axis, Op::Max);    }
+void* ai_min_axis (void* p, int axis) { return reduceAxis("min",    p, axis, Op::Min);    }
+void* ai_argmax   (void* p, int axis) { return reduceAxis("argmax", p, axis, Op::ArgMax); }
+
+} // extern "C"
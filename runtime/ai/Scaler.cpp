@@ -0,0 +1,274 @@
+#include "Tensor.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Feature scaling: every column is mapped to (x - offset[j]) / scale[j], with
+// offset / scale fitted from the column's values:
+//   min-max   (normalize)     offset = min,    scale = max - min
+//   z-score   (standardize)   offset = mean,   scale = standard deviation
+//   robust    (robust_scale)  offset = median, scale = interquartile range
+// A zero scale (a constant column) is replaced by 1.
+//
+// Data is row-major, so both passes walk it in memory order: the fit pass
+// streams row blocks and updates all column statistics per row (an inner
+// loop over contiguous columns that vectorises), the apply pass streams the
+// same rows again. Rows are split across threads, each with its own
+// accumulator row, merged at the end. Robust scaling needs order statistics,
+// so it first transposes the rows block by block into column-major scratch.
+//
+// A fitted scaler keeps offset / scale as an object, so a test set can be
+// transformed with the training set's statistics.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace {
+
+constexpr int64_t SCALE_GRAIN = 1 << 15;   // elements per thread
+constexpr int64_t ROW_BLOCK   = 256;       // rows fetched per rowsData call
+
+enum class Kind { MinMax, Standard, Robust };
+
+struct Scaler {
+    nexa::ObjectHeader obj{[](void* p) { delete static_cast<Scaler*>(p); }};   // must stay first
+    std::vector<float> offset, scale;
+};
+
+int64_t rowGrain(int64_t cols) { return std::max<int64_t>(1, SCALE_GRAIN / std::max<int64_t>(cols, 1)); }
+
+// Run fn(i, row) over the rows [b, e) of t, fetched ROW_BLOCK at a time.
+template <typename Fn>
+void forRows(const nexa::Tensor& t, int64_t b, int64_t e, std::vector<float>& blk, Fn fn) {
+    for (int64_t i0 = b; i0 < e; i0 += ROW_BLOCK) {
+        int64_t nb = std::min(ROW_BLOCK, e - i0), ld;
+        const float* xb = t.rowsData(i0, nb, blk.data(), ld);
+        for (int64_t r = 0; r < nb; ++r) fn(i0 + r, xb + r * ld);
+    }
+}
+
+// ── Fit ───────────────────────────────────────────────────────────────────────
+
+void fitMinMax(const nexa::Tensor& t, Scaler& s) {
+    int64_t rows = t.rows, cols = t.cols, grain = rowGrain(cols);
+    int chunks = std::max(nexa::parallel_chunks(rows, grain), 1);
+    std::vector<float> lo((size_t)chunks * cols), hi((size_t)chunks * cols);
+    std::vector<char>  filled(chunks, 0);
+    nexa::parallel_for(rows, grain, [&](int64_t b, int64_t e, int c) {
+        float* l = &lo[(size_t)c * cols];
+        float* h = &hi[(size_t)c * cols];
+        std::vector<float> blk((size_t)ROW_BLOCK * cols);
+        forRows(t, b, e, blk, [&](int64_t i, const float* r) {
+            if (i == b) { std::copy(r, r + cols, l); std::copy(r, r + cols, h); return; }
+            for (int64_t j = 0; j < cols; ++j) {
+                l[j] = std::min(l[j], r[j]);
+                h[j] = std::max(h[j], r[j]);
+            }
+        });
+        filled[c] = 1;
+    });
+    for (int c = 1; c < chunks; ++c) {
+        if (!filled[c]) continue;
+        for (int64_t j = 0; j < cols; ++j) {
+            lo[j] = std::min(lo[j], lo[(size_t)c * cols + j]);
+            hi[j] = std::max(hi[j], hi[(size_t)c * cols + j]);
+        }
+    }
+    for (int64_t j = 0; j < cols; ++j) {
+        s.offset[j] = lo[j];
+        s.scale[j]  = hi[j] - lo[j];
+    }
+}
+
+// Population mean / standard deviation. Each chunk sums x - x0 and (x - x0)²
+// in double, shifted by its first row so constant-ish columns do not cancel;
+// the chunks are combined with the parallel variance formula.
+void fitStandard(const nexa::Tensor& t, Scaler& s) {
+    int64_t rows = t.rows, cols = t.cols, grain = rowGrain(cols);
+    int chunks = std::max(nexa::parallel_chunks(rows, grain), 1);
+    std::vector<double>  shift((size_t)chunks * cols), s1((size_t)chunks * cols, 0.0), s2((size_t)chunks * cols, 0.0);
+    std::vector<int64_t> count(chunks, 0);
+    nexa::parallel_for(rows, grain, [&](int64_t b, int64_t e, int c) {
+        double* x0 = &shift[(size_t)c * cols];
+        double* a1 = &s1[(size_t)c * cols];
+        double* a2 = &s2[(size_t)c * cols];
+        std::vector<float> blk((size_t)ROW_BLOCK * cols);
+        forRows(t, b, e, blk, [&](int64_t i, const float* r) {
+            if (i == b) std::copy(r, r + cols, x0);
+            for (int64_t j = 0; j < cols; ++j) {
+                double d = r[j] - x0[j];
+                a1[j] += d;
+                a2[j] += d * d;
+            }
+        });
+        count[c] = e - b;
+    });
+    for (int64_t j = 0; j < cols; ++j) {
+        double n = 0, mean = 0, m2 = 0;
+        for (int c = 0; c < chunks; ++c) {
+            double nc = (double)count[c];
+            if (nc == 0) continue;
+            size_t k = (size_t)c * cols + j;
+            double mc = shift[k] + s1[k] / nc, m2c = s2[k] - s1[k] * s1[k] / nc;
+            double delta = mc - mean, tot = n + nc;
+            mean += delta * nc / tot;
+            m2   += m2c + delta * delta * n * nc / tot;
+            n = tot;
+        }
+        s.offset[j] = (float)mean;
+        s.scale[j]  = (float)std::sqrt(std::max(m2, 0.0) / std::max(n, 1.0));
+    }
+}
+
+// q-quantile of v[0, n) with linear interpolation between order statistics.
+// v is reordered; the order statistic lies in v[lo, hi), a range already
+// partitioned from the rest by an earlier call.
+float quantile(float* v, int64_t n, double q, int64_t lo, int64_t hi) {
+    double  pos = q * (double)(n - 1);
+    int64_t k   = (int64_t)pos;
+    std::nth_element(v + lo, v + k, v + hi);
+    float a = v[k];
+    if (k + 1 >= n || pos == (double)k) return a;
+    float b = *std::min_element(v + k + 1, v + n);
+    return (float)(a + (pos - k) * (b - a));
+}
+
+void fitRobust(const nexa::Tensor& t, Scaler& s) {
+    int64_t rows = t.rows, cols = t.cols;
+    // column j → colMajor[j*rows, (j+1)*rows): each row block is scattered
+    // one column at a time, so the writes stay in a few streams
+    std::vector<float> colMajor((size_t)rows * cols);
+    nexa::parallel_for(rows, rowGrain(cols), [&](int64_t b, int64_t e, int) {
+        std::vector<float> blk((size_t)ROW_BLOCK * cols);
+        for (int64_t i0 = b; i0 < e; i0 += ROW_BLOCK) {
+            int64_t nb = std::min(ROW_BLOCK, e - i0), ld;
+            const float* xb = t.rowsData(i0, nb, blk.data(), ld);
+            for (int64_t j = 0; j < cols; ++j) {
+                float* o = &colMajor[(size_t)j * rows + i0];
+                for (int64_t r = 0; r < nb; ++r) o[r] = xb[r * ld + j];
+            }
+        }
+    });
+    nexa::parallel_for(cols, std::max<int64_t>(1, SCALE_GRAIN / std::max<int64_t>(rows, 1)), [&](int64_t b, int64_t e, int) {
+        for (int64_t j = b; j < e; ++j) {
+            float* v = &colMajor[(size_t)j * rows];
+            // after the median's partition each quartile only searches its own side
+            int64_t mid = (rows - 1) / 2;
+            s.offset[j] = quantile(v, rows, 0.50, 0, rows);
+            s.scale[j]  = quantile(v, rows, 0.75, mid, rows) - quantile(v, rows, 0.25, 0, mid + 1);
+        }
+    });
+}
+
+Scaler* fit(Kind kind, const nexa::Tensor& t) {
+    auto* s = new Scaler();
+    s->offset.assign((size_t)t.cols, 0.f);
+    s->scale.assign((size_t)t.cols, 1.f);
+    if (t.rows > 0) {
+        switch (kind) {
+        case Kind::MinMax:   fitMinMax(t, *s);   break;
+        case Kind::Standard: fitStandard(t, *s); break;
+        case Kind::Robust:   fitRobust(t, *s);   break;
+        }
+    }
+    for (float& v : s->scale) if (v == 0.f) v = 1.f;
+    return s;
+}
+
+// ── Apply ─────────────────────────────────────────────────────────────────────
+
+// dst = scaled src, row by row. dst is either a fresh dense [rows x cols]
+// tensor or src itself (in place: each element is read before it is written).
+void apply(const Scaler& s, const nexa::Tensor& src, nexa::Tensor& dst) {
+    int64_t cols = src.cols;
+    const float* off = s.offset.data();
+    const float* sc  = s.scale.data();
+    bool direct = dst.elems && dst.unitColumns();
+    nexa::parallel_for(src.rows, rowGrain(cols), [&](int64_t b, int64_t e, int) {
+        std::vector<float> blk((size_t)ROW_BLOCK * cols);
+        forRows(src, b, e, blk, [&](int64_t i, const float* r) {
+            if (direct) {
+                float* o = dst.elems + i * dst.rowStride;
+                for (int64_t j = 0; j < cols; ++j) o[j] = (r[j] - off[j]) / sc[j];
+            } else {
+                for (int64_t j = 0; j < cols; ++j) dst.set(i, j, (r[j] - off[j]) / sc[j]);
+            }
+        });
+    });
+}
+
+bool checkColumns(const char* name, const Scaler& s, const nexa::Tensor& t) {
+    if ((size_t)t.cols == s.offset.size()) return true;
+    fprintf(stderr, "[nexa] %s: scaler was fitted on %zu columns, got %lld\n",
+            name, s.offset.size(), (long long)t.cols);
+    return false;
+}
+
+nexa::Tensor* scaledCopy(const Scaler& s, const nexa::Tensor& t) {
+    int rows = (int)t.rows, cols = (int)t.cols;
+    auto* out = new nexa::Tensor(nexa::FloatBuffer((size_t)rows * cols), {rows, cols});
+    apply(s, t, *out);
+    return out;
+}
+
+void* scaled(Kind kind, void* p) {
+    auto* t = nexa::tensorArg(p);
+    Scaler* s = fit(kind, *t);
+    auto* out = scaledCopy(*s, *t);
+    delete s;
+    return out;
+}
+
+void scaleInPlace(Kind kind, void* p) {
+    auto* t = nexa::writableArg(p);
+    Scaler* s = fit(kind, *t);
+    apply(*s, *t, *t);
+    delete s;
+}
+
+void* scaledReuse(Kind kind, void* p) {
+    auto* t = nexa::writableArg(p);
+    if (!nexa::reusable(t)) return scaled(kind, p);
+    scaleInPlace(kind, t);
+    ai_retain(t);
+    return t;
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LLVM Bridge
+// ─────────────────────────────────────────────────────────────────────────────
+extern "C" {
+
+void* ml_normalize(void* p)    { return scaled(Kind::MinMax, p); }
+void* ml_standardize(void* p)  { return scaled(Kind::Standard, p); }
+void* ml_robust_scale(void* p) { return scaled(Kind::Robust, p); }
+
+void ml_normalize_(void* p)    { scaleInPlace(Kind::MinMax, p); }
+void ml_standardize_(void* p)  { scaleInPlace(Kind::Standard, p); }
+void ml_robust_scale_(void* p) { scaleInPlace(Kind::Robust, p); }
+
+void* ml_normalize_reuse(void* p)    { return scaledReuse(Kind::MinMax, p); }
+void* ml_standardize_reuse(void* p)  { return scaledReuse(Kind::Standard, p); }
+void* ml_robust_scale_reuse(void* p) { return scaledReuse(Kind::Robust, p); }
+
+void* ml_minmax_scaler(void* p)   { return fit(Kind::MinMax, *nexa::tensorArg(p)); }
+void* ml_standard_scaler(void* p) { return fit(Kind::Standard, *nexa::tensorArg(p)); }
+void* ml_robust_scaler(void* p)   { return fit(Kind::Robust, *nexa::tensorArg(p)); }
+
+void* ml_transform(void* sp, void* p) {
+    auto* s = static_cast<Scaler*>(sp);
+    auto* t = nexa::tensorArg(p);
+    if (!checkColumns("transform", *s, *t)) return nullptr;
+    return scaledCopy(*s, *t);
+}
+
+void ml_transform_(void* sp, void* p) {
+    auto* s = static_cast<Scaler*>(sp);
+    auto* t = nexa::writableArg(p);
+    if (checkColumns("transform_", *s, *t)) apply(*s, *t, *t);
+}
+
+} // extern "C"
@@ -0,0 +1,240 @@
+#include "Small.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace nexa {
+
+// ── Tensor recycling ──────────────────────────────────────────────────────────
+
+static constexpr size_t SMALL_CACHE_PER_SIZE = 16;
+
+static thread_local bool smallCacheGone = false;   // tensors freed during thread exit
+
+namespace {
+struct SmallCache {
+    std::vector<Tensor*> lists[9];      // indexed by n
+    ~SmallCache() {
+        smallCacheGone = true;
+        for (auto& l : lists)
+            for (Tensor* t : l) delete t;
+    }
+};
+} // namespace
+
+static thread_local SmallCache smallCache;
+
+Tensor* smallTensor(int n) {
+    if (smallCacheGone) return new Tensor(FloatBuffer((size_t)n * n), {n, n});
+    auto& l = smallCache.lists[n];
+    if (l.empty()) return new Tensor(FloatBuffer((size_t)n * n), {n, n});
+    Tensor* t = l.back();
+    l.pop_back();
+    t->obj.refs.store(1, std::memory_order_relaxed);
+    return t;
+}
+
+bool recycleSmall(Tensor* t) {
+    // dense f32 square of a cached size, and no view still shares the buffer
+    if (smallCacheGone || t->ndim() != 2 || t->rows != t->cols || !smallSize(t->rows) || !t->elems || t->packed ||
+        t->offset != 0 || t->rowStride != t->cols || t->colStride != 1 ||
+        t->storage.use_count() != 1 || t->storage->size() != (size_t)(t->rows * t->cols))
+        return false;
+    auto& l = smallCache.lists[t->rows];
+    if (l.size() >= SMALL_CACHE_PER_SIZE) return false;
+    l.push_back(t);
+    return true;
+}
+
+// Element (i, j) of every operand lands in m[i * N + j]; N is a template
+// argument whenever it can be, so the index arithmetic folds away.
+template <int N, typename T>
+static inline void gather(SmallMatrix a, T* m) {
+#pragma GCC unroll 64
+    for (int i = 0; i < N * N; ++i) m[i] = (T)a.p[(i / N) * a.rs + (i % N) * a.cs];
+}
+
+// ── Matrix multiply / transpose ───────────────────────────────────────────────
+
+template <int N>
+void smallMatmul(SmallMatrix a, SmallMatrix b, float* c) {
+    float A[N * N], B[N * N];
+    gather<N>(a, A);
+    if (b.rs == N && b.cs == 1) std::copy(b.p, b.p + N * N, B);   // dense: lets the copy vectorise
+    else gather<N>(b, B);
+#pragma GCC unroll 8
+    for (int i = 0; i < N; ++i) {
+        float row[N] = {};
+#pragma GCC unroll 8
+        for (int k = 0; k < N; ++k) {
+            const float aik = A[i * N + k];
+#pragma GCC unroll 8
+            for (int j = 0; j < N; ++j) row[j] += aik * B[k * N + j];
+        }
+#pragma GCC unroll 8
+        for (int j = 0; j < N; ++j) c[i * N + j] = row[j];
+    }
+}
+
+template <int N>
+void smallTranspose(SmallMatrix a, float* c) {
+#pragma GCC unroll 64
+    for (int i = 0; i < N * N; ++i) c[(i % N) * N + i / N] = a.p[(i / N) * a.rs + (i % N) * a.cs];
+}
+
+template void smallMatmul<2>(SmallMatrix, SmallMatrix, float*);
+template void smallMatmul<3>(SmallMatrix, SmallMatrix, float*);
+template void smallMatmul<4>(SmallMatrix, SmallMatrix, float*);
+template void smallMatmul<8>(SmallMatrix, SmallMatrix, float*);
+template void smallTranspose<2>(SmallMatrix, float*);
+template void smallTranspose<3>(SmallMatrix, float*);
+template void smallTranspose<4>(SmallMatrix, float*);
+template void smallTranspose<8>(SmallMatrix, float*);
+
+bool smallMatmul(int n, SmallMatrix a, SmallMatrix b, float* c) {
+    switch (n) {
+    case 2: smallMatmul<2>(a, b, c); return true;
+    case 3: smallMatmul<3>(a, b, c); return true;
+    case 4: smallMatmul<4>(a, b, c); return true;
+    case 8: smallMatmul<8>(a, b, c); return true;
+    }
+    return false;
+}
+
+bool smallTranspose(int n, SmallMatrix a, float* c) {
+    switch (n) {
+    case 2: smallTranspose<2>(a, c); return true;
+    case 3: smallTranspose<3>(a, c); return true;
+    case 4: smallTranspose<4>(a, c); return true;
+    case 8: smallTranspose<8>(a, c); return true;
+    }
+    return false;
+}
+
+// ── Determinant / inverse ─────────────────────────────────────────────────────
+
+// Gauss-Jordan elimination of the sz x sz matrix m (row-major, destroyed)
+// with partial pivoting. Returns the determinant; when inv is set it also
+// receives the inverse (valid only if the determinant is non-zero). Without
+// inv only the rows below each pivot are eliminated. N > 0 fixes the size
+// so the loops unroll; N == 0 takes it from n.
+template <int N>
+static double gaussJordan(int n, double* m, double* inv) {
+    const int sz = N ? N : n;
+    if (inv)
+        for (int i = 0; i < sz * sz; ++i) inv[i] = i / sz == i % sz ? 1.0 : 0.0;
+    double det = 1.0;
+#pragma GCC unroll 8
+    for (int col = 0; col < sz; ++col) {
+        int piv = col;
+        for (int r = col + 1; r < sz; ++r)
+            if (std::fabs(m[r * sz + col]) > std::fabs(m[piv * sz + col])) piv = r;
+        const double p = m[piv * sz + col];
+        if (p == 0.0) return 0.0;
+        if (piv != col) {
+            det = -det;
+            for (int j = 0; j < sz; ++j) std::swap(m[piv * sz + j], m[col * sz + j]);
+            if (inv)
+                for (int j = 0; j < sz; ++j) std::swap(inv[piv * sz + j], inv[col * sz + j]);
+        }
+        det *= p;
+        const double ip = 1.0 / p;
+#pragma GCC unroll 8
+        for (int j = 0; j < sz; ++j) m[col * sz + j] *= ip;
+        if (inv)
+#pragma GCC unroll 8
+            for (int j = 0; j < sz; ++j) inv[col * sz + j] *= ip;
+        for (int r = inv ? 0 : col + 1; r < sz; ++r) {
+            const double f = m[r * sz + col];
+            if (r == col || f == 0.0) continue;
+#pragma GCC unroll 8
+            for (int j = 0; j < sz; ++j) m[r * sz + j] -= f * m[col * sz + j];
+            if (inv)
+#pragma GCC unroll 8
+                for (int j = 0; j < sz; ++j) inv[r * sz + j] -= f * inv[col * sz + j];
+        }
+    }
+    return det;
+}
+
+template <int N>
+static double detFixed(SmallMatrix a) {
+    double m[N * N];
+    gather<N>(a, m);
+    return gaussJordan<N>(N, m, nullptr);
+}
+
+template <int N>
+static bool invertFixed(SmallMatrix a, float* out) {
+    double m[N * N], inv[N * N];
+    gather<N>(a, m);
+    if (gaussJordan<N>(N, m, inv) == 0.0) return false;
+#pragma GCC unroll 64
+    for (int i = 0; i < N * N; ++i) out[i] = (float)inv[i];
+    return true;
+}
+
+static void gatherDynamic(int n, SmallMatrix a, double* m) {
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j) m[i * n + j] = a.p[i * a.rs + j * a.cs];
+}
+
+float determinant(int n, SmallMatrix a) {
+    auto e = [&](int i, int j) { return (double)a.p[i * a.rs + j * a.cs]; };
+    switch (n) {
+    case 0: return 1.f;
+    case 1: return a.p[0];
+    case 2: return (float)(e(0, 0) * e(1, 1) - e(0, 1) * e(1, 0));
+    case 3: return (float)(e(0, 0) * (e(1, 1) * e(2, 2) - e(1, 2) * e(2, 1))
+                         - e(0, 1) * (e(1, 0) * e(2, 2) - e(1, 2) * e(2, 0))
+                         + e(0, 2) * (e(1, 0) * e(2, 1) - e(1, 1) * e(2, 0)));
+    case 4: return (float)detFixed<4>(a);
+    case 8: return (float)detFixed<8>(a);
+    }
+    std::vector<double> m((size_t)n * n);
+    gatherDynamic(n, a, m.data());
+    return (float)gaussJordan<0>(n, m.data(), nullptr);
+}
+
+bool invert(int n, SmallMatrix a, float* out) {
+    auto e = [&](int i, int j) { return (double)a.p[i * a.rs + j * a.cs]; };
+    switch (n) {
+    case 0: return true;
+    case 1:
+        if (a.p[0] == 0.f) return false;
+        out[0] = 1.f / a.p[0];
+        return true;
+    case 2: {
+        double det = e(0, 0) * e(1, 1) - e(0, 1) * e(1, 0);
+        if (det == 0.0) return false;
+        double id = 1.0 / det;
+        out[0] = (float)( e(1, 1) * id);  out[1] = (float)(-e(0, 1) * id);
+        out[2] = (float)(-e(1, 0) * id);  out[3] = (float)( e(0, 0) * id);
+        return true;
+    }
+    case 3: {
+        // adjugate: out[j][i] is the (i, j) cofactor
+        double c[9];
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j) {
+                int i0 = (i + 1) % 3, i1 = (i + 2) % 3, j0 = (j + 1) % 3, j1 = (j + 2) % 3;
+                c[j * 3 + i] = e(i0, j0) * e(i1, j1) - e(i0, j1) * e(i1, j0);
+            }
+        double det = e(0, 0) * c[0] + e(0, 1) * c[3] + e(0, 2) * c[6];
+        if (det == 0.0) return false;
+        double id = 1.0 / det;
+        for (int i = 0; i < 9; ++i) out[i] = (float)(c[i] * id);
+        return true;
+    }
+    case 4: return invertFixed<4>(a, out);
+    case 8: return invertFixed<8>(a, out);
+    }
+    std::vector<double> m((size_t)n * n), inv((size_t)n * n);
+    gatherDynamic(n, a, m.data());
+    if (gaussJordan<0>(n, m.data(), inv.data()) == 0.0) return false;
+    for (size_t i = 0; i < inv.size(); ++i) out[i] = (float)inv[i];
+    return true;
+}
+
+} // namespace nexa
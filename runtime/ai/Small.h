@@ -0,0 +1,60 @@
+#pragma once
+#include "Tensor.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace nexa {
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Kernels for small square matrices: 2x2, 3x3, 4x4 and 8x8, the sizes of
+// transforms and tiny models. At these sizes the generic paths (packing,
+// scratch buffers, thread-pool dispatch) cost more than the arithmetic, so
+// each kernel is a template instantiated per size with its loops fully
+// unrolled, working on operands gathered into stack arrays.
+//
+// Operands are f32 matrices given by element 0 and row / column strides, so
+// views (a transpose(), a csv_slice) are read in place. Results are written
+// dense row-major. The runtime picks these at the call boundary; when sema
+// knows both shapes statically the compiler calls ai_matmul_<n> directly.
+//
+// Results come from smallTensor(): when a dense small square tensor dies
+// with no views left on its buffer, Tensor::destroy parks the whole object
+// (header, buffer, shape) in a per-thread cache instead of freeing it, so a
+// loop of small-matrix ops reuses the same few tensors and stops touching
+// the heap after its first iteration.
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct SmallMatrix {
+    const float*   p;
+    std::ptrdiff_t rs, cs;   // row / column stride in elements
+};
+
+constexpr bool smallSize(int64_t n) { return n == 2 || n == 3 || n == 4 || n == 8; }
+
+// A fresh dense f32 [n x n] tensor (n a small size), elements uninitialised.
+Tensor* smallTensor(int n);
+
+// c[N x N] = a * b
+template <int N> void smallMatmul(SmallMatrix a, SmallMatrix b, float* c);
+// c[N x N] = aᵀ
+template <int N> void smallTranspose(SmallMatrix a, float* c);
+
+// Runtime-sized front ends: false when n has no fixed-size kernel.
+bool smallMatmul(int n, SmallMatrix a, SmallMatrix b, float* c);
+bool smallTranspose(int n, SmallMatrix a, float* c);
+
+// out[i] = op(a[i], b[i]) over N*N dense elements
+template <int N, typename Op>
+inline void smallBinary(const float* a, const float* b, float* out, Op op) {
+#pragma GCC unroll 64
+    for (int i = 0; i < N * N; ++i) out[i] = op(a[i], b[i]);
+}
+
+// Determinant and inverse of an n x n matrix, any n. 2x2 and 3x3 use the
+// closed forms; other sizes use Gauss-Jordan elimination with partial
+// pivoting in double precision, unrolled for 4x4 and 8x8. invert() writes
+// the dense inverse to out and returns false when a is singular.
+float determinant(int n, SmallMatrix a);
+bool  invert(int n, SmallMatrix a, float* out);
+
+} // namespace nexa
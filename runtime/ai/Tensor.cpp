@@ -1,116 +1,367 @@
 #include "Tensor.h"
+#include "Gemm.h"
+#include "Lazy.h"
+#include "Parallel.h"
+#include "Small.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
 #include <numeric>
 
 namespace nexa {
-Tensor matmul(const Tensor& A, const Tensor& B) {
+bool Tensor::isContiguous() const {
+    int64_t expect=1;
+    for(size_t d=shape.size();d-->0;){if(shape[d]!=1&&strides[d]!=expect)return false;expect*=shape[d];}
+    return true;
+}
+FloatBuffer Tensor::contiguousCopy() const {
+    FloatBuffer out(numel());
+    if(isContiguous()){decode(dtype,raw(),(int64_t)out.size(),out.data(),quant);return out;}
+    if(unitRows()){   // transposed view: blocked transpose instead of strided gathers
+        if(elems&&rows==cols&&smallTranspose((int)rows,{elems,colStride,rowStride},out.data()))return out;
+        if(elems){transpose(cols,rows,elems,colStride,out.data(),cols,4);return out;}
+        Tensor d=denseCopy();decode(dtype,d.raw(),(int64_t)out.size(),out.data(),quant);return out;
+    }
+    for(int64_t i=0;i<rows;i++){float*o=out.data()+i*cols;const float*r=rowData(i,o);if(r!=o)std::copy(r,r+cols,o);}
+    return out;
+}
+const float* Tensor::rowMajorData(FloatBuffer& scratch,int64_t& ld) const {
+    if(elems&&unitColumns()){ld=rows>1?rowStride:cols;return data();}
+    scratch=contiguousCopy();ld=cols;return scratch.data();
+}
+const float* Tensor::rowData(int64_t i,float* buf) const {
+    if(elems&&unitColumns())return elems+i*rowStride;
+    if(unitColumns()){decode(dtype,static_cast<const uint8_t*>(raw())+i*rowStride*(int64_t)dtypeSize(dtype),cols,buf,quant);return buf;}
+    for(int64_t j=0;j<cols;j++)buf[j]=get(i,j);
+    return buf;
+}
+const float* Tensor::rowsData(int64_t i,int64_t n,float* buf,int64_t& ld) const {
+    if(elems&&unitColumns()){ld=rows>1?rowStride:cols;return elems+i*rowStride;}
+    ld=cols;
+    if(unitColumns()&&(rowStride==cols||n==1)){decode(dtype,static_cast<const uint8_t*>(raw())+i*rowStride*(int64_t)dtypeSize(dtype),n*cols,buf,quant);return buf;}
+    for(int64_t r=0;r<n;r++){float*o=buf+r*cols;const float*src=rowData(i+r,o);if(src!=o)std::copy(src,src+cols,o);}
+    return buf;
+}
+const float* Tensor::denseData(FloatBuffer& scratch) const {
+    if(elems&&isContiguous())return data();
+    scratch=contiguousCopy();return scratch.data();
+}
+Tensor Tensor::denseCopy() const {
+    if(dtype==DType::F32)return Tensor(contiguousCopy(),shape);
+    size_t n=numel(),sz=dtypeSize(dtype);ByteBuffer out(n*sz);const uint8_t*src=static_cast<const uint8_t*>(raw());
+    if(isContiguous())std::copy(src,src+n*sz,out.data());
+    else if(unitRows())transpose(cols,rows,src,colStride,out.data(),cols,sz);
+    else for(int64_t i=0;i<rows;i++)for(int64_t j=0;j<cols;j++)std::copy_n(src+(i*rowStride+j*colStride)*sz,sz,out.data()+(i*cols+j)*sz);
+    return Tensor(dtype,std::move(out),shape,quant);
+}
+Tensor Tensor::converted(DType to) const {
+    if(to==dtype)return denseCopy();
+    FloatBuffer scratch;const float*x=denseData(scratch);size_t n=numel();
+    if(to==DType::F32)return Tensor(x==scratch.data()?std::move(scratch):FloatBuffer(x,x+n),shape);
+    QuantParams q;
+    if(to==DType::I8&&n){auto mm=std::minmax_element(x,x+n);q=chooseQuantParams(*mm.first,*mm.second);}
+    ByteBuffer out(n*dtypeSize(to));
+    // encode in parallel blocks: conversions of large feature matrices are bandwidth-bound
+    parallel_for((int64_t)n,1<<16,[&](int64_t b,int64_t e,int){encode(to,x+b,e-b,out.data()+b*dtypeSize(to),q);});
+    return Tensor(to,std::move(out),shape,q);
+}
+// Quantised product of two 2-D int8 tensors; the result is f32 [m x p]
+static Tensor matmulI8(const Tensor& A, const Tensor& B){
+    Tensor a=A.isContiguous()?Tensor(A,A.offset,A.shape,A.strides):A.denseCopy();
+    Tensor b=B.isContiguous()?Tensor(B,B.offset,B.shape,B.strides):B.denseCopy();
+    int m=(int)a.rows,n=(int)a.cols,p=(int)b.cols;
+    Tensor out(FloatBuffer((size_t)m*p),{m,p});
+    qgemm_s8(m,p,n, static_cast<const int8_t*>(a.raw()),n,a.quant.zeroPoint,
+                   static_cast<const int8_t*>(b.raw()),p,b.quant.zeroPoint,
+                   a.quant.scale*b.quant.scale, out.data(),p);
+    return out;
+}
+bool matmulShape(const Tensor& A, const Tensor& B, std::vector<int>& out) {
+    int na=A.ndim(),nb=B.ndim();
+    if(na<2||nb<2||A.shape[na-1]!=B.shape[nb-2])return false;
+    int nd=std::max(na,nb);out.assign(nd,1);
+    // batch dimensions broadcast right-aligned: equal, or one of them is 1
+    for(int d=0;d<nd-2;d++){int x=d-(nd-na)>=0?A.shape[d-(nd-na)]:1,y=d-(nd-nb)>=0?B.shape[d-(nd-nb)]:1;
+        if(x!=y&&x!=1&&y!=1)return false;
+        out[d]=x==1?y:x;}
+    out[nd-2]=A.shape[na-2];out[nd-1]=B.shape[nb-1];
+    return true;
+}
+// Offset of each output batch matrix inside a dense operand (0 along broadcast dimensions)
+static std::vector<int64_t> batchOffsets(const std::vector<int>& outShape,const Tensor& T,int64_t batch){
+    int nd=(int)outShape.size(),nt=T.ndim();int64_t mat=(int64_t)T.shape[nt-2]*T.shape[nt-1];
+    std::vector<int64_t> off(batch,0);
+    for(int64_t i=0;i<batch;i++){int64_t rem=i,mul=mat;
+        for(int d=nd-3;d>=0;d--){int idx=(int)(rem%outShape[d]);rem/=outShape[d];int td=d-(nd-nt);if(td<0)break;
+            if(T.shape[td]!=1)off[i]+=idx*mul;
+            mul*=T.shape[td];}}
+    return off;
+}
+// A 2-D f32 operand as the GEMM engine takes it: row-major, or a transpose()
+// view passed as Transpose::Yes on the underlying matrix; anything else is copied
+static const float* gemmOperand(const Tensor& T,FloatBuffer& scratch,int64_t& ld,Transpose& tr){
+    tr=Transpose::No;
+    if(T.elems&&T.unitRows()){tr=Transpose::Yes;ld=T.colStride;return T.data();}
+    return T.rowMajorData(scratch,ld);
+}
+Tensor matmul2d(const Tensor& A, const Tensor& B) {
     int m=A.shape[0],n=A.shape[1],p=B.shape[1];
-    std::vector<float> result(m*p,0.f);
-    for(int i=0;i<m;i++) for(int j=0;j<p;j++){float s=0;for(int k=0;k<n;k++)s+=A.data[i*n+k]*B.data[k*p+j];result[i*p+j]=s;}
-    return Tensor(result,{m,p});
+    if(A.dtype==DType::I8||B.dtype==DType::I8){
+        // int8 × anything: quantise the other operand per call and multiply in int32
+        if(A.dtype!=DType::I8)return matmulI8(A.converted(DType::I8),B);
+        if(B.dtype!=DType::I8)return matmulI8(A,B.converted(DType::I8));
+        return matmulI8(A,B);
+    }
+    FloatBuffer sa,sb;int64_t lda,ldb;Transpose ta,tb;
+    const float* a=gemmOperand(A,sa,lda,ta);const float* b=gemmOperand(B,sb,ldb,tb);
+    Tensor out(FloatBuffer((size_t)m*p),{m,p});
+    sgemm(ta,tb,m,p,n, a,lda, b,ldb, out.data(),p);
+    return out;
+}
+Tensor matmul(const Tensor& A, const Tensor& B) {
+    if(A.ndim()==2&&B.ndim()==2)return matmul2d(A,B);
+    std::vector<int> shape;matmulShape(A,B,shape);
+    int nd=(int)shape.size(),m=shape[nd-2],p=shape[nd-1],n=A.shape[A.ndim()-1];
+    // Batched: every [m x n] * [n x p] pair goes to the GEMM engine in one call
+    int64_t batch=1;for(int d=0;d<nd-2;d++)batch*=shape[d];
+    FloatBuffer sa,sb;const float* a=A.denseData(sa);const float* b=B.denseData(sb);
+    Tensor out(FloatBuffer((size_t)batch*m*p),shape);
+    std::vector<int64_t> oa=batchOffsets(shape,A,batch),ob=batchOffsets(shape,B,batch);
+    std::vector<const float*> pa(batch),pb(batch);std::vector<float*> pc(batch);
+    for(int64_t i=0;i<batch;i++){pa[i]=a+oa[i];pb[i]=b+ob[i];pc[i]=out.data()+i*m*p;}
+    sgemm_batched((int)batch,m,p,n, pa.data(),n, pb.data(),p, pc.data(),p);
+    return out;
 }
+Tensor* writableArg(void* p){if(nexa_lazy_pending)nexa_lazy_flush();return tensorArg(p);}
 } // namespace nexa
 
+static constexpr int64_t ROW_BLOCK=256;   // rows decoded per call for reduced dtypes
 static float sigmoid(float x){return 1.f/(1.f+std::exp(-x));}
-static std::string trim(const std::string& s){size_t a=s.find_first_not_of(" \t\r\n"),b=s.find_last_not_of(" \t\r\n");return(a==std::string::npos)?"":s.substr(a,b-a+1);}
-static std::vector<std::string> splitLine(const std::string& line,char d=','){std::vector<std::string> t;std::stringstream ss(line);std::string tok;while(std::getline(ss,tok,d))t.push_back(trim(tok));return t;}
+static std::string shapeStr(const std::vector<int>& s){std::string r="[";for(size_t d=0;d<s.size();d++){if(d)r+=" x ";r+=std::to_string(s[d]);}return r+"]";}
 
-struct LogisticModel{std::vector<float> weights;float bias=0;int n_features=0,max_iter=100;float lr=0.01f;};
+struct LogisticModel{
+    nexa::ObjectHeader obj{[](void* p){delete static_cast<LogisticModel*>(p);}};  // must stay first
+    std::vector<float> weights;float bias=0;int n_features=0,max_iter=100;float lr=0.01f;
+};
+
+// Data-prep transforms work on a tensor's own elements, so each ML op has an
+// in-place form (name_) next to the copying one; writes through a view reach its parent.
+static void shuffleRows(nexa::Tensor* t){
+    int rows=(int)t->rows,cols=(int)t->cols;int64_t sz=(int64_t)nexa::dtypeSize(t->dtype);uint8_t*base=static_cast<uint8_t*>(t->raw());
+    auto el=[&](int64_t i,int64_t j){return base+(i*t->rowStride+j*t->colStride)*sz;};   // swapped as raw bytes: no re-rounding
+    srand((unsigned)time(nullptr));for(int i=rows-1;i>0;i--){int j=rand()%(i+1);if(j!=i)for(int c=0;c<cols;c++)std::swap_ranges(el(i,c),el(i,c)+sz,el(j,c));}
+}
+template<typename F> static void mapElements(nexa::Tensor* t,F f){
+    int64_t rows=t->rows,cols=t->cols;
+    nexa::parallel_for(rows,std::max<int64_t>(1,(1<<15)/std::max<int64_t>(cols,1)),[&](int64_t rb,int64_t re,int){
+        for(int64_t i=rb;i<re;i++){
+            if(t->elems&&t->unitColumns()){float*r=t->elems+i*t->rowStride;for(int64_t j=0;j<cols;j++)r[j]=f(r[j]);}
+            else for(int64_t j=0;j<cols;j++)t->set(i,j,f(t->get(i,j)));}
+    });
+}
+static nexa::Tensor* denseMatrix(const nexa::Tensor* t){return new nexa::Tensor(t->contiguousCopy(),{(int)t->rows,(int)t->cols});}
+
+// [N x N] * [N x N] known at compile time: straight to the unrolled kernel
+template<int N> static void* matmulFixed(void* a,void* b){
+    auto*A=nexa::tensorArg(a);auto*B=nexa::tensorArg(b);
+    if(!A->elems||!B->elems)return new nexa::Tensor(nexa::matmul2d(*A,*B));
+    auto*out=nexa::smallTensor(N);
+    nexa::smallMatmul<N>({A->elems,A->rowStride,A->colStride},{B->elems,B->rowStride,B->colStride},out->data());
+    return out;
+}
 
 extern "C" {
 
-void* ai_create_matrix(int r,int c){return new nexa::Tensor(std::vector<float>(r*c,0.f),{r,c});}
-void  ai_set_value(void* p,int r,int c,float v){auto*t=static_cast<nexa::Tensor*>(p);t->data[r*t->shape[1]+c]=v;}
-float ai_get_value(void* p,int r,int c){auto*t=static_cast<nexa::Tensor*>(p);return t->data[r*t->shape[1]+c];}
-void* ai_matmul(void* a,void* b){auto*A=static_cast<nexa::Tensor*>(a);auto*B=static_cast<nexa::Tensor*>(b);nexa::Tensor r=nexa::matmul(*A,*B);return new nexa::Tensor(r.data,r.shape);}
-void  ai_print(void* p){auto*t=static_cast<nexa::Tensor*>(p);int rows=t->shape[0],cols=t->shape[1];std::cout<<"[";for(int i=0;i<rows;i++){if(i>0)std::cout<<" ";std::cout<<"[";for(int j=0;j<cols;j++){std::cout<<t->data[i*cols+j];if(j<cols-1)std::cout<<", ";}std::cout<<"]";if(i<rows-1)std::cout<<",\n";}std::cout<<"]"<<std::endl;}
-void* ai_zeros(int r,int c){return new nexa::Tensor(std::vector<float>(r*c,0.f),{r,c});}
-void* ai_ones(int r,int c){return new nexa::Tensor(std::vector<float>(r*c,1.f),{r,c});}
-float ai_sum(void* p){auto*t=static_cast<nexa::Tensor*>(p);float s=0;for(float v:t->data)s+=v;return s;}
-float ai_mean(void* p){auto*t=static_cast<nexa::Tensor*>(p);if(t->data.empty())return 0;float s=0;for(float v:t->data)s+=v;return s/t->data.size();}
-float ai_max(void* p){auto*t=static_cast<nexa::Tensor*>(p);if(t->data.empty())return 0;float m=t->data[0];for(float v:t->data)if(v>m)m=v;return m;}
-float ai_min(void* p){auto*t=static_cast<nexa::Tensor*>(p);if(t->data.empty())return 0;float m=t->data[0];for(float v:t->data)if(v<m)m=v;return m;}
-void* ai_reshape(void* p,int r,int c){auto*t=static_cast<nexa::Tensor*>(p);return new nexa::Tensor(t->data,{r,c});}
-void* ai_shape(void* p){auto*t=static_cast<nexa::Tensor*>(p);return new nexa::Tensor({(float)t->shape[0],(float)t->shape[1]},{1,2});}
+void  ai_retain(void* p){if(p)static_cast<nexa::ObjectHeader*>(p)->refs.fetch_add(1,std::memory_order_relaxed);}
+void  ai_release(void* p){
+    if(!p)return;
+    auto*h=static_cast<nexa::ObjectHeader*>(p);
+    if(h->refs.fetch_sub(1,std::memory_order_acq_rel)==1)h->destroy(p);
+}
+
+void* ai_create_matrix(int r,int c){return new nexa::Tensor(nexa::FloatBuffer((size_t)r*c,0.f),{r,c});}
+void* ai_from_data(const float* d,int r,int c){return new nexa::Tensor(nexa::FloatBuffer(d,d+(size_t)r*c),{r,c});}
+void  ai_set_value(void* p,int r,int c,float v){if(nexa_lazy_pending)nexa_lazy_flush();nexa::tensorArg(p)->set(r,c,v);}
+float ai_get_value(void* p,int r,int c){return nexa::tensorArg(p)->get(r,c);}
+// Square f32 [n x n] * [n x n] of a small size: unrolled kernel into a recycled
+// tensor, operands read in place; nullptr when that doesn't apply
+static void* smallProduct(const nexa::Tensor* A,const nexa::Tensor* B){
+    int n=(int)A->rows;
+    if(A->ndim()!=2||B->ndim()!=2||A->cols!=n||B->rows!=n||B->cols!=n||!nexa::smallSize(n)||!A->elems||!B->elems)return nullptr;
+    nexa::Tensor*out=nexa::smallTensor(n);
+    nexa::smallMatmul(n,{A->elems,A->rowStride,A->colStride},{B->elems,B->rowStride,B->colStride},out->data());
+    return out;
+}
+void* ai_matmul(void* a,void* b){
+    auto*A=nexa::tensorArg(a);auto*B=nexa::tensorArg(b);std::vector<int> shape;
+    if(void*s=smallProduct(A,B))return s;
+    if(!nexa::matmulShape(*A,*B,shape)){fprintf(stderr,"[nexa] matmul shape mismatch: %s * %s\n",shapeStr(A->shape).c_str(),shapeStr(B->shape).c_str());return nullptr;}
+    return new nexa::Tensor(nexa::matmul(*A,*B));
+}
+void* ai_matmul_2d(void* a,void* b){
+    auto*A=nexa::tensorArg(a);auto*B=nexa::tensorArg(b);
+    if(void*s=smallProduct(A,B))return s;
+    return new nexa::Tensor(nexa::matmul2d(*A,*B));
+}
+void* ai_matmul_2(void* a,void* b){return matmulFixed<2>(a,b);}
+void* ai_matmul_3(void* a,void* b){return matmulFixed<3>(a,b);}
+void* ai_matmul_4(void* a,void* b){return matmulFixed<4>(a,b);}
+void* ai_matmul_8(void* a,void* b){return matmulFixed<8>(a,b);}
+// Square matrices only; reduced dtypes are decoded first
+static const nexa::Tensor* squareF32(const char* fn,void* p,nexa::Tensor& tmp){
+    auto*t=nexa::tensorArg(p);
+    if(t->ndim()!=2||t->rows!=t->cols){fprintf(stderr,"[nexa] %s: expected a square matrix, got %s\n",fn,shapeStr(t->shape).c_str());return nullptr;}
+    if(t->elems)return t;
+    tmp=t->converted(nexa::DType::F32);return &tmp;
+}
+float ai_det(void* p){nexa::Tensor tmp;auto*t=squareF32("det",p,tmp);if(!t)return 0.f;return nexa::determinant((int)t->rows,{t->elems,t->rowStride,t->colStride});}
+void* ai_inverse(void* p){
+    nexa::Tensor tmp;auto*t=squareF32("inverse",p,tmp);if(!t)return nullptr;
+    int n=(int)t->rows;auto*out=nexa::smallSize(n)?nexa::smallTensor(n):new nexa::Tensor(nexa::FloatBuffer(t->numel()),t->shape);
+    if(!nexa::invert(n,{t->elems,t->rowStride,t->colStride},out->data())){fprintf(stderr,"[nexa] inverse: matrix is singular\n");ai_release(out);return nullptr;}
+    return out;
+}
+// Nested brackets, one level per dimension; the innermost one is printed as a row
+static void printDims(const nexa::Tensor* t,int d,int64_t off){
+    int n=t->shape[d];std::cout<<"[";
+    if(d==t->ndim()-1){for(int j=0;j<n;j++){std::cout<<t->flat(off+j*t->strides[d]);if(j<n-1)std::cout<<", ";}}
+    else for(int i=0;i<n;i++){if(i>0)std::cout<<",\n"<<std::string(d+1,' ');printDims(t,d+1,off+i*t->strides[d]);}
+    std::cout<<"]";
+}
+void  ai_print(void* p){auto*t=nexa::tensorArg(p);if(t->ndim()==0)std::cout<<"[]";else printDims(t,0,0);std::cout<<std::endl;}
+void* ai_zeros(int r,int c){return new nexa::Tensor(nexa::FloatBuffer((size_t)r*c,0.f),{r,c});}
+void* ai_ones(int r,int c){return new nexa::Tensor(nexa::FloatBuffer((size_t)r*c,1.f),{r,c});}
+static bool validDims(const char* fn,const int* dims,int ndim){
+    if(ndim<1){fprintf(stderr,"[nexa] %s: a tensor needs at least one dimension\n",fn);return false;}
+    for(int d=0;d<ndim;d++)if(dims[d]<0){fprintf(stderr,"[nexa] %s: negative dimension %d\n",fn,dims[d]);return false;}
+    return true;
+}
+static size_t dimsProduct(const std::vector<int>& s){size_t n=1;for(int d:s)n*=(size_t)d;return n;}
+void* ai_zeros_nd(const int* dims,int ndim){if(!validDims("zeros",dims,ndim))return nullptr;std::vector<int> s(dims,dims+ndim);return new nexa::Tensor(nexa::FloatBuffer(dimsProduct(s),0.f),s);}
+void* ai_ones_nd(const int* dims,int ndim){if(!validDims("ones",dims,ndim))return nullptr;std::vector<int> s(dims,dims+ndim);return new nexa::Tensor(nexa::FloatBuffer(dimsProduct(s),1.f),s);}
+void* ai_reshape_nd(void* p,const int* dims,int ndim){
+    auto*t=nexa::tensorArg(p);if(!validDims("reshape",dims,ndim))return nullptr;std::vector<int> s(dims,dims+ndim);
+    if(dimsProduct(s)!=t->numel()){fprintf(stderr,"[nexa] reshape: cannot view %zu elements as %s\n",t->numel(),shapeStr(s).c_str());return nullptr;}
+    if(t->isContiguous())return new nexa::Tensor(*t,t->offset,s,nexa::Tensor::denseStrides(s));   // O(1) view
+    nexa::Tensor c=t->denseCopy();return new nexa::Tensor(c,0,s,nexa::Tensor::denseStrides(s));
+}
+void* ai_reshape(void* p,int r,int c){int dims[2]={r,c};return ai_reshape_nd(p,dims,2);}
+void* ai_transpose(void* p){
+    auto*t=nexa::tensorArg(p);int nd=t->ndim();
+    if(nd==0)return new nexa::Tensor(*t,t->offset,t->shape,t->strides);
+    if(nd==1)return new nexa::Tensor(*t,t->offset,{t->shape[0],1},{t->strides[0],1});   // vector -> column
+    std::vector<int> s=t->shape;std::swap(s[nd-2],s[nd-1]);
+    if(nd==2)return new nexa::Tensor(*t,t->offset,s,{t->strides[1],t->strides[0]});     // O(1) view
+    // Batches keep the flattened [rows x cols] header walkable, so each matrix is transposed into place
+    nexa::Tensor d=t->isContiguous()?nexa::Tensor(*t,t->offset,t->shape,t->strides):t->denseCopy();
+    int64_t r=t->shape[nd-2],c=t->shape[nd-1],batch=(int64_t)t->numel()/std::max<int64_t>(r*c,1);size_t sz=nexa::dtypeSize(t->dtype);
+    auto*out=t->dtype==nexa::DType::F32?new nexa::Tensor(nexa::FloatBuffer(t->numel()),s):new nexa::Tensor(t->dtype,nexa::ByteBuffer(t->numel()*sz),s,t->quant);
+    const uint8_t*src=static_cast<const uint8_t*>(d.raw());uint8_t*dst=static_cast<uint8_t*>(out->raw());
+    for(int64_t b=0;b<batch;b++)nexa::transpose(r,c,src+b*r*c*sz,c,dst+b*r*c*sz,r,sz);
+    return out;
+}
+void* ai_shape(void* p){auto*t=static_cast<nexa::Tensor*>(p);nexa::FloatBuffer s(t->shape.begin(),t->shape.end());return new nexa::Tensor(std::move(s),{1,t->ndim()});}
+// Precision
+void* ai_to_f32(void* p){return new nexa::Tensor(nexa::tensorArg(p)->converted(nexa::DType::F32));}
+void* ai_to_bf16(void* p){return new nexa::Tensor(nexa::tensorArg(p)->converted(nexa::DType::BF16));}
+void* ai_to_f16(void* p){return new nexa::Tensor(nexa::tensorArg(p)->converted(nexa::DType::F16));}
+void* ai_quantize(void* p){return new nexa::Tensor(nexa::tensorArg(p)->converted(nexa::DType::I8));}
+const char* ai_dtype(void* p){return nexa::dtypeName(static_cast<nexa::Tensor*>(p)->dtype);}
+int   ai_ndim(void* p){return static_cast<nexa::Tensor*>(p)->ndim();}
+int   ai_dim(void* p,int axis){auto*t=static_cast<nexa::Tensor*>(p);int nd=t->ndim(),a=axis<0?axis+nd:axis;
+    if(a<0||a>=nd){fprintf(stderr,"[nexa] dim: axis %d out of range for a %d-d tensor\n",axis,nd);return 0;}
+    return t->shape[a];}
 
 // CSV
-void* csv_read(const char* path,int skip_header){
-    std::ifstream f(path);if(!f.is_open()){fprintf(stderr,"[nexa] cannot open CSV '%s'\n",path);return nullptr;}
-    std::vector<std::vector<float>> rows;std::string line;bool first=true;
-    while(std::getline(f,line)){if(trim(line).empty())continue;if(first&&skip_header){first=false;continue;}first=false;
-        auto toks=splitLine(line);std::vector<float> row;for(auto& tok:toks){try{row.push_back(std::stof(tok));}catch(...){row.push_back(0.f);}}if(!row.empty())rows.push_back(row);}
-    if(rows.empty())return new nexa::Tensor({},{0,0});
-    int nr=(int)rows.size(),nc=(int)rows[0].size();std::vector<float> data;
-    for(auto& r:rows){r.resize(nc,0.f);for(float v:r)data.push_back(v);}
-    return new nexa::Tensor(data,{nr,nc});
-}
-void  csv_write(const char* path,void* tp){auto*t=static_cast<nexa::Tensor*>(tp);if(!t)return;std::ofstream f(path);if(!f.is_open())return;int rows=t->shape[0],cols=t->shape[1];for(int i=0;i<rows;i++){for(int j=0;j<cols;j++){f<<t->data[i*cols+j];if(j<cols-1)f<<",";}f<<"\n";}}
-int   csv_rows(void* p){return static_cast<nexa::Tensor*>(p)->shape[0];}
-int   csv_cols(void* p){return static_cast<nexa::Tensor*>(p)->shape[1];}
-float csv_get(void* p,int r,int c){auto*t=static_cast<nexa::Tensor*>(p);return t->data[r*t->shape[1]+c];}
-void  csv_set(void* p,int r,int c,float v){auto*t=static_cast<nexa::Tensor*>(p);t->data[r*t->shape[1]+c]=v;}
-void* csv_get_row(void* p,int row){auto*t=static_cast<nexa::Tensor*>(p);int c=t->shape[1];return new nexa::Tensor(std::vector<float>(t->data.begin()+row*c,t->data.begin()+row*c+c),{1,c});}
-void* csv_get_col(void* p,int col){auto*t=static_cast<nexa::Tensor*>(p);int r=t->shape[0],c=t->shape[1];std::vector<float> d;for(int i=0;i<r;i++)d.push_back(t->data[i*c+col]);return new nexa::Tensor(d,{r,1});}
-void* csv_slice_cols(void* p,int cs,int ce){auto*t=static_cast<nexa::Tensor*>(p);int r=t->shape[0],c=t->shape[1],nc=ce-cs;std::vector<float> d;for(int i=0;i<r;i++)for(int j=cs;j<ce&&j<c;j++)d.push_back(t->data[i*c+j]);return new nexa::Tensor(d,{r,nc});}
+int   csv_rows(void* p){return (int)static_cast<nexa::Tensor*>(p)->rows;}
+int   csv_cols(void* p){return (int)static_cast<nexa::Tensor*>(p)->cols;}
+float csv_get(void* p,int r,int c){return nexa::tensorArg(p)->get(r,c);}
+void  csv_set(void* p,int r,int c,float v){if(nexa_lazy_pending)nexa_lazy_flush();nexa::tensorArg(p)->set(r,c,v);}
+// Rows, columns and column ranges are views onto the source tensor's buffer.
+// N-d tensors are addressed as their flattened [rows x cols] matrix.
+static std::vector<int64_t> matrixStrides(const nexa::Tensor* t){return{t->rowStride,t->colStride};}
+void* csv_get_row(void* p,int row){auto*t=nexa::tensorArg(p);int rows=(int)t->rows,cols=(int)t->cols;
+    if(row<0||row>=rows){fprintf(stderr,"[nexa] csv_row: row %d out of range [0, %d)\n",row,rows);return nullptr;}
+    return new nexa::Tensor(*t,t->offset+row*t->rowStride,{1,cols},matrixStrides(t));}
+void* csv_get_col(void* p,int col){auto*t=nexa::tensorArg(p);int rows=(int)t->rows,cols=(int)t->cols;
+    if(col<0||col>=cols){fprintf(stderr,"[nexa] csv_col: column %d out of range [0, %d)\n",col,cols);return nullptr;}
+    return new nexa::Tensor(*t,t->offset+col*t->colStride,{rows,1},matrixStrides(t));}
+void* csv_slice_cols(void* p,int cs,int ce){auto*t=nexa::tensorArg(p);
+    cs=std::max(cs,0);ce=std::min(ce,(int)t->cols);
+    if(cs>ce){fprintf(stderr,"[nexa] csv_slice: empty column range [%d, %d)\n",cs,ce);return nullptr;}
+    return new nexa::Tensor(*t,t->offset+cs*t->colStride,{(int)t->rows,ce-cs},matrixStrides(t));}
 
 // ML ops
-void* ml_normalize(void* p){
-    auto*t=static_cast<nexa::Tensor*>(p);int rows=t->shape[0],cols=t->shape[1];std::vector<float> out=t->data;
-    for(int j=0;j<cols;j++){float mn=out[j],mx=out[j];for(int i=1;i<rows;i++){float v=out[i*cols+j];if(v<mn)mn=v;if(v>mx)mx=v;}float rng=mx-mn;if(rng==0)rng=1;for(int i=0;i<rows;i++)out[i*cols+j]=(out[i*cols+j]-mn)/rng;}
-    return new nexa::Tensor(out,{rows,cols});
-}
-void* ml_shuffle(void* p){
-    auto*t=static_cast<nexa::Tensor*>(p);int rows=t->shape[0],cols=t->shape[1];std::vector<float> out=t->data;
-    srand((unsigned)time(nullptr));for(int i=rows-1;i>0;i--){int j=rand()%(i+1);for(int c=0;c<cols;c++)std::swap(out[i*cols+c],out[j*cols+c]);}
-    return new nexa::Tensor(out,{rows,cols});
-}
-void* ml_train_split(void* p,float ratio){auto*t=static_cast<nexa::Tensor*>(p);int rows=t->shape[0],cols=t->shape[1],n=(int)(rows*ratio);std::vector<float> d(t->data.begin(),t->data.begin()+n*cols);return new nexa::Tensor(d,{n,cols});}
-void* ml_test_split(void* p,float ratio){auto*t=static_cast<nexa::Tensor*>(p);int rows=t->shape[0],cols=t->shape[1],n=(int)(rows*ratio);std::vector<float> d(t->data.begin()+n*cols,t->data.end());return new nexa::Tensor(d,{rows-n,cols});}
-void* ml_hstack(void* ap,void* bp){auto*A=static_cast<nexa::Tensor*>(ap);auto*B=static_cast<nexa::Tensor*>(bp);int rows=A->shape[0],ca=A->shape[1],cb=B->shape[1];std::vector<float> out;for(int i=0;i<rows;i++){for(int j=0;j<ca;j++)out.push_back(A->data[i*ca+j]);for(int j=0;j<cb;j++)out.push_back(B->data[i*cb+j]);}return new nexa::Tensor(out,{rows,ca+cb});}
+void* ml_shuffle(void* p){auto*out=denseMatrix(nexa::tensorArg(p));shuffleRows(out);return out;}
+void* ml_clip(void* p,float lo,float hi){auto*out=denseMatrix(nexa::tensorArg(p));mapElements(out,[=](float v){return std::min(std::max(v,lo),hi);});return out;}
+void  ml_shuffle_(void* p){shuffleRows(nexa::writableArg(p));}
+void  ml_scale_(void* p,float s){mapElements(nexa::writableArg(p),[=](float v){return v*s;});}
+void  ml_clip_(void* p,float lo,float hi){mapElements(nexa::writableArg(p),[=](float v){return std::min(std::max(v,lo),hi);});}
+void* ml_shuffle_reuse(void* p){auto*t=nexa::writableArg(p);if(!nexa::reusable(t))return ml_shuffle(p);shuffleRows(t);ai_retain(t);return t;}
+void* ml_clip_reuse(void* p,float lo,float hi){auto*t=nexa::writableArg(p);if(!nexa::reusable(t))return ml_clip(p,lo,hi);ml_clip_(t,lo,hi);ai_retain(t);return t;}
+// Splits are row-range views: no data is copied
+static int splitRow(const nexa::Tensor* t,float ratio){return std::min(std::max((int)(t->rows*ratio),0),(int)t->rows);}
+void* ml_train_split(void* p,float ratio){auto*t=nexa::tensorArg(p);int n=splitRow(t,ratio);return new nexa::Tensor(*t,t->offset,{n,(int)t->cols},matrixStrides(t));}
+void* ml_test_split(void* p,float ratio){auto*t=nexa::tensorArg(p);int n=splitRow(t,ratio);return new nexa::Tensor(*t,t->offset+n*t->rowStride,{(int)t->rows-n,(int)t->cols},matrixStrides(t));}
+void* ml_hstack(void* ap,void* bp){auto*A=nexa::tensorArg(ap);auto*B=nexa::tensorArg(bp);int rows=(int)A->rows,ca=(int)A->cols,cb=(int)B->cols;
+    nexa::FloatBuffer out((size_t)rows*(ca+cb));float*o=out.data();
+    for(int i=0;i<rows;i++){for(int j=0;j<ca;j++)*o++=A->get(i,j);for(int j=0;j<cb;j++)*o++=B->get(i,j);}
+    return new nexa::Tensor(std::move(out),{rows,ca+cb});}
 
 // Logistic Regression
 void* lore_create(int max_iter,float lr){auto*m=new LogisticModel();m->max_iter=max_iter;m->lr=lr;return m;}
 void  lore_fit(void* mp,void* Xp,void* yp){
-    auto*model=static_cast<LogisticModel*>(mp);auto*X=static_cast<nexa::Tensor*>(Xp);auto*y=static_cast<nexa::Tensor*>(yp);
-    int n=X->shape[0],nf=X->shape[1];model->n_features=nf;model->weights.assign(nf,0.f);model->bias=0.f;
-    for(int iter=0;iter<model->max_iter;iter++){std::vector<float> dw(nf,0.f);float db=0.f;
-        for(int i=0;i<n;i++){float z=model->bias;for(int j=0;j<nf;j++)z+=model->weights[j]*X->data[i*nf+j];
-            float err=sigmoid(z)-y->data[i];for(int j=0;j<nf;j++)dw[j]+=err*X->data[i*nf+j];db+=err;}
-        for(int j=0;j<nf;j++)model->weights[j]-=model->lr*dw[j]/n;model->bias-=model->lr*db/n;}
+    auto*model=static_cast<LogisticModel*>(mp);auto*X=nexa::tensorArg(Xp);auto*y=nexa::tensorArg(yp);
+    int n=(int)X->rows,nf=(int)X->cols;model->n_features=nf;model->weights.assign(nf,0.f);model->bias=0.f;
+    nexa::FloatBuffer ys;const float*yd=y->denseData(ys);
+    // each chunk of rows accumulates its own gradient (nf weights + bias), summed after the pass;
+    // bf16 / f16 / i8 rows are decoded ROW_BLOCK at a time into the chunk's buffer
+    int64_t grain=std::max(1,(1<<14)/std::max(nf,1));int chunks=nexa::parallel_chunks(n,grain);
+    std::vector<float> part((size_t)std::max(chunks,1)*(nf+1));
+    for(int iter=0;iter<model->max_iter;iter++){std::fill(part.begin(),part.end(),0.f);
+        nexa::parallel_for(n,grain,[&](int64_t rb,int64_t re,int c){float*dw=&part[(size_t)c*(nf+1)];std::vector<float> blk((size_t)ROW_BLOCK*nf);
+            for(int64_t i0=rb;i0<re;i0+=ROW_BLOCK){int64_t nb=std::min<int64_t>(ROW_BLOCK,re-i0),ld;const float*xb=X->rowsData(i0,nb,blk.data(),ld);
+            for(int64_t r=0;r<nb;r++){int i=(int)(i0+r);const float*x=xb+r*ld;float z=model->bias;for(int j=0;j<nf;j++)z+=model->weights[j]*x[j];
+                float err=sigmoid(z)-yd[i];for(int j=0;j<nf;j++)dw[j]+=err*x[j];dw[nf]+=err;}}});
+        for(int c=1;c<chunks;c++)for(int j=0;j<=nf;j++)part[j]+=part[(size_t)c*(nf+1)+j];
+        for(int j=0;j<nf;j++)model->weights[j]-=model->lr*part[j]/n;model->bias-=model->lr*part[nf]/n;}
 }
 void* lore_predict(void* mp,void* Xp){
-    auto*model=static_cast<LogisticModel*>(mp);auto*X=static_cast<nexa::Tensor*>(Xp);
-    int n=X->shape[0],nf=X->shape[1];std::vector<float> out(n);
-    for(int i=0;i<n;i++){float z=model->bias;for(int j=0;j<nf;j++)z+=model->weights[j]*X->data[i*nf+j];out[i]=sigmoid(z)>=0.5f?1.f:0.f;}
-    return new nexa::Tensor(out,{n,1});
+    auto*model=static_cast<LogisticModel*>(mp);auto*X=nexa::tensorArg(Xp);
+    int n=(int)X->rows,nf=(int)X->cols;nexa::FloatBuffer out(n);
+    nexa::parallel_for(n,std::max(1,(1<<14)/std::max(nf,1)),[&](int64_t rb,int64_t re,int){std::vector<float> blk((size_t)ROW_BLOCK*nf);
+        for(int64_t i0=rb;i0<re;i0+=ROW_BLOCK){int64_t nb=std::min<int64_t>(ROW_BLOCK,re-i0),ld;const float*xb=X->rowsData(i0,nb,blk.data(),ld);
+        for(int64_t r=0;r<nb;r++){int i=(int)(i0+r);const float*x=xb+r*ld;float z=model->bias;for(int j=0;j<nf;j++)z+=model->weights[j]*x[j];out[i]=sigmoid(z)>=0.5f?1.f:0.f;}}});
+    return new nexa::Tensor(std::move(out),{n,1});
 }
 void* lore_predict_proba(void* mp,void* Xp){
-    auto*model=static_cast<LogisticModel*>(mp);auto*X=static_cast<nexa::Tensor*>(Xp);
-    int n=X->shape[0],nf=X->shape[1];std::vector<float> out(n);
-    for(int i=0;i<n;i++){float z=model->bias;for(int j=0;j<nf;j++)z+=model->weights[j]*X->data[i*nf+j];out[i]=sigmoid(z);}
-    return new nexa::Tensor(out,{n,1});
+    auto*model=static_cast<LogisticModel*>(mp);auto*X=nexa::tensorArg(Xp);
+    int n=(int)X->rows,nf=(int)X->cols;nexa::FloatBuffer out(n);
+    nexa::parallel_for(n,std::max(1,(1<<14)/std::max(nf,1)),[&](int64_t rb,int64_t re,int){std::vector<float> blk((size_t)ROW_BLOCK*nf);
+        for(int64_t i0=rb;i0<re;i0+=ROW_BLOCK){int64_t nb=std::min<int64_t>(ROW_BLOCK,re-i0),ld;const float*xb=X->rowsData(i0,nb,blk.data(),ld);
+        for(int64_t r=0;r<nb;r++){int i=(int)(i0+r);const float*x=xb+r*ld;float z=model->bias;for(int j=0;j<nf;j++)z+=model->weights[j]*x[j];out[i]=sigmoid(z);}}});
+    return new nexa::Tensor(std::move(out),{n,1});
 }
 float ml_accuracy(void* predp,void* labelp){
-    auto*pred=static_cast<nexa::Tensor*>(predp);auto*label=static_cast<nexa::Tensor*>(labelp);
-    int n=(int)pred->data.size();if(n==0)return 0.f;int correct=0;
-    for(int i=0;i<n;i++)if(std::round(pred->data[i])==std::round(label->data[i]))correct++;
+    auto*pred=nexa::tensorArg(predp);auto*label=nexa::tensorArg(labelp);
+    int n=(int)pred->numel();if(n==0)return 0.f;int correct=0;
+    nexa::FloatBuffer ps,ls;const float*pd=pred->denseData(ps);const float*ld=label->denseData(ls);
+    for(int i=0;i<n;i++)if(std::round(pd[i])==std::round(ld[i]))correct++;
     return(float)correct/n;
 }
 void* ml_confusion(void* predp,void* labelp){
-    auto*pred=static_cast<nexa::Tensor*>(predp);auto*label=static_cast<nexa::Tensor*>(labelp);
-    int n=(int)pred->data.size();float tp=0,fp=0,fn=0,tn=0;
-    for(int i=0;i<n;i++){int p=(int)std::round(pred->data[i]),l=(int)std::round(label->data[i]);if(p==1&&l==1)tp++;else if(p==1&&l==0)fp++;else if(p==0&&l==1)fn++;else tn++;}
+    auto*pred=nexa::tensorArg(predp);auto*label=nexa::tensorArg(labelp);
+    int n=(int)pred->numel();float tp=0,fp=0,fn=0,tn=0;
+    nexa::FloatBuffer ps,ls;const float*pd=pred->denseData(ps);const float*ld=label->denseData(ls);
+    for(int i=0;i<n;i++){int p=(int)std::round(pd[i]),l=(int)std::round(ld[i]);if(p==1&&l==1)tp++;else if(p==1&&l==0)fp++;else if(p==0&&l==1)fn++;else tn++;}
     return new nexa::Tensor({tp,fp,fn,tn},{2,2});
 }
-void* lore_weights(void* mp){auto*m=static_cast<LogisticModel*>(mp);return new nexa::Tensor(m->weights,{1,m->n_features});}
+void* lore_weights(void* mp){auto*m=static_cast<LogisticModel*>(mp);return new nexa::Tensor(nexa::FloatBuffer(m->weights.begin(),m->weights.end()),{1,m->n_features});}
 float lore_bias(void* mp){return static_cast<LogisticModel*>(mp)->bias;}
 
 } // extern "C"
\ No newline at end of file
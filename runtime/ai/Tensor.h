@@ -1,19 +1,226 @@
 #pragma once
+#include "Allocator.h"
+#include "DType.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 
 namespace nexa {
 
-struct Tensor {
-    std::vector<float> data;
-    std::vector<int>   shape;
+// ─────────────────────────────────────────────────────────────────────────────
+// Every heap object handed to compiled Nexa code (tensors, model handles)
+// starts with this header, so ai_retain / ai_release work on any handle.
+// Objects are born with one reference, owned by whoever called the runtime
+// function that created them; CodeGen inserts the matching releases.
+// ─────────────────────────────────────────────────────────────────────────────
+struct ObjectHeader {
+    std::atomic<int> refs{1};
+    void (*destroy)(void*);
+
+    explicit ObjectHeader(void (*d)(void*)) : destroy(d) {}
+    // A copied object is a new object — it starts with its own single reference
+    ObjectHeader(const ObjectHeader& o) : refs(1), destroy(o.destroy) {}
+    ObjectHeader& operator=(const ObjectHeader&) { return *this; }
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// A tensor is an N-d strided view of a shared float buffer:
+//   element (i0, i1, …) = storage[offset + i0*strides[0] + i1*strides[1] + …]
+// Tensors built from fresh data own a dense row-major buffer; row, column,
+// slice and split functions return views onto the same buffer in O(1), so a
+// view keeps its parent's data alive and writes through a view are visible
+// in the parent. Buffers come from the pooled allocator (Allocator.h) and
+// are 64-byte aligned. A tensor loaded from a binary tensor file
+// (TensorFile.cpp) keeps its elements in the file mapping instead (mapped);
+// views of it share the mapping the same way.
+//
+// Matrix-shaped code sees any tensor as [rows x cols]: cols is the last
+// dimension and rows the product of all others (header fields below). The
+// runtime only builds N-d views whose leading dimensions flatten that way
+// (dense ones, or 2-D views), so at(i, j) and the row pointers stay valid.
+//
+// Kernels that walk rows take rowMajorData() (zero-copy whenever columns are
+// unit-stride) or rowData() one row at a time; those that need a flat array
+// take denseData(). They copy into the caller's scratch buffer only when the
+// layout or the dtype demands it.
+//
+// A tensor's elements are fp32 (storage) or a reduced type (packed, see
+// DType.h). Offsets and strides count elements either way, so views work
+// the same for every dtype. Reduced tensors have elems == nullptr: code that
+// needs floats goes through get() / rowData() / denseData(), which decode.
+// ─────────────────────────────────────────────────────────────────────────────
 
-    Tensor() {}
-    Tensor(const std::vector<float>& d, const std::vector<int>& s)
-        : data(d), shape(s) {}
+// ── C ABI header ──────────────────────────────────────────────────────────────
+// Every tensor handle starts with this fixed layout. Generated code reads it
+// directly, so get_value / set_value / csv_rows / … compile to inline loads
+// and stores instead of runtime calls. The fields never change after the
+// tensor is built, except that a pending lazy result (Lazy.h) has
+// elems == nullptr until it is evaluated. CodeGen mirrors this struct as
+//   { i32 refs, ptr destroy, ptr elems, i64 rows, i64 cols, i64 rowStride, i64 colStride }
+// — keep the two in sync.
+struct TensorHeader {
+    ObjectHeader obj;
+    float*       elems = nullptr;        // element (0, 0); nullptr unless dtype is f32
+    int64_t      rows = 0, cols = 0;
+    int64_t      rowStride = 0, colStride = 0;   // in floats
+
+    explicit TensorHeader(void (*destroy)(void*)) : obj(destroy) {}
 };
+static_assert(offsetof(TensorHeader, elems)     == 16, "tensor ABI: elems");
+static_assert(offsetof(TensorHeader, rows)      == 24, "tensor ABI: rows");
+static_assert(offsetof(TensorHeader, colStride) == 48, "tensor ABI: colStride");
+
+struct LazyExpr;
+
+struct Tensor : TensorHeader {
+    std::shared_ptr<FloatBuffer> storage;                 // f32 elements
+    std::shared_ptr<ByteBuffer>  packed;                  // bf16 / f16 / i8 elements
+    std::shared_ptr<uint8_t>     mapped;                  // elements of any dtype in a file mapping
+    DType                        dtype = DType::F32;
+    QuantParams                  quant;                   // i8 only
+    int64_t                      offset = 0;              // in elements
+    std::vector<int>             shape;
+    std::vector<int64_t>         strides;                 // in elements, one per dimension
+    std::shared_ptr<const LazyExpr> pending;              // lazy mode: not evaluated yet (Lazy.h)
+
+    Tensor() : TensorHeader(&Tensor::destroy), storage(std::make_shared<FloatBuffer>()) { syncHeader(); }
+    Tensor(FloatBuffer d, const std::vector<int>& s)
+        : TensorHeader(&Tensor::destroy), storage(std::make_shared<FloatBuffer>(std::move(d))),
+          shape(s), strides(denseStrides(s)) { syncHeader(); }
+    Tensor(std::shared_ptr<FloatBuffer> d, const std::vector<int>& s)
+        : TensorHeader(&Tensor::destroy), storage(std::move(d)), shape(s), strides(denseStrides(s)) { syncHeader(); }
+    Tensor(DType t, ByteBuffer d, const std::vector<int>& s, QuantParams q = {})
+        : TensorHeader(&Tensor::destroy), packed(std::make_shared<ByteBuffer>(std::move(d))),
+          dtype(t), quant(q), shape(s), strides(denseStrides(s)) { syncHeader(); }
+    Tensor(DType t, std::shared_ptr<uint8_t> m, const std::vector<int>& s, QuantParams q = {})
+        : TensorHeader(&Tensor::destroy), mapped(std::move(m)),
+          dtype(t), quant(q), shape(s), strides(denseStrides(s)) { syncHeader(); }
+    Tensor(const Tensor& base, int64_t off, const std::vector<int>& s, const std::vector<int64_t>& st)
+        : TensorHeader(&Tensor::destroy), storage(base.storage), packed(base.packed), mapped(base.mapped), dtype(base.dtype),
+          quant(base.quant), offset(off), shape(s), strides(st) { syncHeader(); }
+
+    // f32 only — nullptr for reduced dtypes
+    float*       data()       { return elems; }
+    const float* data() const { return elems; }
+
+    // Element 0 in storage, whatever the dtype.
+    const void* raw() const {
+        return dtype == DType::F32 ? (const void*)elems
+                                   : (const void*)((mapped ? mapped.get() : packed->data()) + offset * (int64_t)dtypeSize(dtype));
+    }
+    void* raw() { return const_cast<void*>(static_cast<const Tensor*>(this)->raw()); }
+
+    // Element at index i (in elements) from element 0, decoded to fp32
+    float flat(int64_t i) const { return elems ? elems[i] : decodeOne(dtype, raw(), i, quant); }
+
+    int ndim() const { return (int)shape.size(); }
+
+    // Element (i, j) of the flattened [rows x cols] matrix. at() is f32 only;
+    // get() / set() work for every dtype (set() rounds / quantises).
+    float& at(int64_t i, int64_t j)       { return elems[i * rowStride + j * colStride]; }
+    float  at(int64_t i, int64_t j) const { return elems[i * rowStride + j * colStride]; }
+    float  get(int64_t i, int64_t j) const { return flat(i * rowStride + j * colStride); }
+    void   set(int64_t i, int64_t j, float v) {
+        if (elems) at(i, j) = v;
+        else       encodeOne(dtype, v, raw(), i * rowStride + j * colStride, quant);
+    }
+
+    size_t numel() const {
+        size_t n = 1;
+        for (int d : shape) n *= (size_t)d;
+        return n;
+    }
+    bool isContiguous() const;   // dense row-major (size-1 dimensions ignored)
+    bool unitColumns()  const { return cols <= 1 || colStride == 1; }
+    // Column-major matrix, i.e. a transpose() view of a row-major one:
+    // column j starts at j*colStride and its rows are adjacent.
+    bool unitRows()     const { return ndim() <= 2 && rows > 1 && cols > 1 && rowStride == 1; }
+
+    // Row i starts at rows + i*ld and its columns are adjacent.
+    const float* rowMajorData(FloatBuffer& scratch, int64_t& ld) const;
+    // Row i of the [rows x cols] matrix as floats: a pointer into the tensor
+    // when it is f32 with unit-stride columns, else decoded into buf (cols floats).
+    const float* rowData(int64_t i, float* buf) const;
+    // Rows [i, i+n) the same way: row i+r starts at result + r*ld; decoded
+    // rows land in buf (n*cols floats) with ld = cols.
+    const float* rowsData(int64_t i, int64_t n, float* buf, int64_t& ld) const;
+    // All numel() elements, dense and row-major.
+    const float* denseData(FloatBuffer& scratch) const;
+    FloatBuffer  contiguousCopy() const;        // decoded to f32
+    Tensor       denseCopy() const;             // same dtype, dense row-major
+    Tensor       converted(DType to) const;     // dense copy in another dtype
+
+    static std::vector<int64_t> denseStrides(const std::vector<int>& s) {
+        std::vector<int64_t> st(s.size(), 1);
+        for (size_t d = s.size(); d-- > 1; ) st[d - 1] = st[d] * s[d];
+        return st;
+    }
+
+    // Refresh the ABI header from storage / offset / shape / strides.
+    // rowStride comes from the innermost leading dimension of size > 1.
+    void syncHeader() {
+        int nd    = ndim();
+        elems     = dtype != DType::F32 || pending ? nullptr
+                  : (mapped ? reinterpret_cast<float*>(mapped.get()) : storage->data()) + offset;
+        cols      = nd > 0 ? shape[nd - 1] : 0;
+        colStride = nd > 0 ? strides[nd - 1] : 1;
+        rows      = nd > 0 ? 1 : 0;
+        rowStride = cols;
+        for (int d = nd - 2; d >= 0; --d) rows *= shape[d];
+        for (int d = nd - 2; d >= 0; --d)
+            if (shape[d] != 1) { rowStride = strides[d]; break; }
+    }
+
+    static void destroy(void* p);
+};
+
+// Evaluate a pending lazy tensor in place (no-op otherwise), and drop a
+// pending tensor from the flush list (Lazy.cpp).
+void materialize(Tensor& t);
+void forgetPending(Tensor* t);
+
+// Park a dead small square tensor for reuse by smallTensor() (Small.h);
+// false when it does not qualify and must be freed.
+bool recycleSmall(Tensor* t);
+
+inline void Tensor::destroy(void* p) {
+    auto* t = static_cast<Tensor*>(p);
+    if (t->pending) forgetPending(t);
+    else if (recycleSmall(t)) return;
+    delete t;
+}
+
+// The tensor behind a runtime handle, evaluated first if it is pending.
+// Every runtime entry point that reads elements takes its tensors this way.
+inline Tensor* tensorArg(void* p) {
+    auto* t = static_cast<Tensor*>(p);
+    if (t && t->pending) materialize(*t);
+    return t;
+}
+
+// tensorArg() for an op about to overwrite the tensor: pending results that
+// may still read it are evaluated first.
+Tensor* writableArg(void* p);
 
+// x = f(x): the old x dies with the assignment, so its buffer can take the
+// result when the caller's reference is the only one, nothing views the
+// buffer, and the in-place result is what f would return anyway
+// (f32 [rows x cols]).
+inline bool reusable(const Tensor* t) {
+    return t->ndim() == 2 && t->elems && t->obj.refs.load(std::memory_order_relaxed) == 1 &&
+           t->storage.use_count() == 1;
+}
+
+// Matrix product over the last two dimensions; leading (batch) dimensions
+// broadcast like element-wise ops. matmulShape() computes the result shape
+// and returns false when the operands are incompatible; matmul() assumes
+// they are compatible.
+bool   matmulShape(const Tensor& A, const Tensor& B, std::vector<int>& out);
 Tensor matmul(const Tensor& A, const Tensor& B);
+Tensor matmul2d(const Tensor& A, const Tensor& B);   // both 2-D, [m x n] * [n x p]
 
 } // namespace nexa
 
@@ -22,28 +229,139 @@ Tensor matmul(const Tensor& A, const Tensor& B);
 // ─────────────────────────────────────────────────────────────────────────────
 extern "C" {
 
+// ── Reference counting ────────────────────────
+// Both accept any runtime handle and ignore nullptr.
+void   ai_retain(void* ptr);
+void   ai_release(void* ptr);       // frees the object when the count hits 0
+
 // ── Tensor ops ────────────────────────────────
 void*  ai_create_matrix(int rows, int cols);
+void*  ai_from_data(const float* data, int rows, int cols);   // copies rows*cols floats
 void   ai_set_value(void* ptr, int r, int c, float val);
-void*  ai_matmul(void* a, void* b);
+void*  ai_matmul(void* a, void* b);      // [..., m x n] * [..., n x p], batched
+void*  ai_matmul_2d(void* a, void* b);   // [m x n] * [n x p], shapes already checked by the compiler
+// [N x N] * [N x N] on the unrolled kernels (Small.h), N = 2, 3, 4, 8
+void*  ai_matmul_2(void* a, void* b);
+void*  ai_matmul_3(void* a, void* b);
+void*  ai_matmul_4(void* a, void* b);
+void*  ai_matmul_8(void* a, void* b);
 void   ai_print(void* ptr);
 void*  ai_zeros(int rows, int cols);
 void*  ai_ones(int rows, int cols);
+void*  ai_reshape(void* ptr, int r, int c);
+void*  ai_shape(void* ptr);             // [1 x ndim]
+void*  ai_transpose(void* ptr);         // swaps the last two dims; O(1) view for matrices
+float  ai_get_value(void* ptr, int r, int c);
+
+// ── Linear algebra (Small.h) ──────────────────
+// Square matrices only: anything else prints an error and returns 0 /
+// nullptr, as does inverting a singular matrix.
+float  ai_det(void* ptr);
+void*  ai_inverse(void* ptr);
+
+// ── N-d tensors ───────────────────────────────
+// dims points at ndim sizes. reshape returns a view when the source is
+// contiguous and a copy otherwise.
+void*  ai_zeros_nd(const int* dims, int ndim);
+void*  ai_ones_nd(const int* dims, int ndim);
+void*  ai_reshape_nd(void* ptr, const int* dims, int ndim);
+int    ai_ndim(void* ptr);
+int    ai_dim(void* ptr, int axis);    // negative axes count from the end
+
+// ── Precision ─────────────────────────────────
+// Dense copies in another element type (DType.h). quantize picks a per-tensor
+// int8 scale / zero point from the value range. Every op accepts any dtype
+// and computes in fp32; matmul with an int8 operand runs in int8 / int32.
+void*  ai_to_f32(void* ptr);
+void*  ai_to_bf16(void* ptr);
+void*  ai_to_f16(void* ptr);
+void*  ai_quantize(void* ptr);
+const char* ai_dtype(void* ptr);        // "f32", "bf16", "f16" or "i8"
+
+// ── Reductions (Reduce.cpp) ───────────────────
+// Whole tensor → scalar (0 for an empty tensor)
 float  ai_sum(void* ptr);
 float  ai_mean(void* ptr);
 float  ai_max(void* ptr);
 float  ai_min(void* ptr);
-void*  ai_reshape(void* ptr, int r, int c);
-void*  ai_shape(void* ptr);
-float  ai_get_value(void* ptr, int r, int c);
+
+// Along an axis: 0 → [1 x cols] (per column), 1 → [rows x 1] (per row).
+// Returns nullptr (after printing an error) for any other axis. N-d tensors
+// reduce as their flattened [rows x cols] matrix.
+void*  ai_sum_axis (void* ptr, int axis);
+void*  ai_mean_axis(void* ptr, int axis);
+void*  ai_max_axis (void* ptr, int axis);
+void*  ai_min_axis (void* ptr, int axis);
+void*  ai_argmax   (void* ptr, int axis);     // index of the first maximum
+
+// ── Element-wise ops (Elementwise.cpp) ────────
+// Tensor ⊕ tensor with broadcasting: shapes align on the last dimension and
+// each dimension must match or be 1 (batches broadcast the same way).
+// Returns nullptr (after printing an error) on a shape mismatch.
+void*  ai_add(void* a, void* b);
+void*  ai_sub(void* a, void* b);
+void*  ai_mul(void* a, void* b);          // Hadamard product
+void*  ai_div(void* a, void* b);
+
+// Same ops for operands the compiler has proven to share one static shape:
+// no broadcasting and no shape check.
+void*  ai_add_same(void* a, void* b);
+void*  ai_sub_same(void* a, void* b);
+void*  ai_mul_same(void* a, void* b);
+void*  ai_div_same(void* a, void* b);
+
+// Tensor ⊕ scalar; the r* variants compute scalar ⊕ tensor
+void*  ai_add_scalar (void* t, float s);
+void*  ai_sub_scalar (void* t, float s);
+void*  ai_mul_scalar (void* t, float s);
+void*  ai_div_scalar (void* t, float s);
+void*  ai_rsub_scalar(void* t, float s);
+void*  ai_rdiv_scalar(void* t, float s);
 
 // ── CSV ops ───────────────────────────────────
-// Read a numeric CSV file into a Tensor (floats).
-// Header row is skipped if skip_header != 0.
+// Read a numeric CSV file into a Tensor (floats), mapped and parsed in
+// place (Csv.cpp). Header row is skipped if skip_header != 0. With
+// NEXA_CSV_CACHE=1 the result is also saved to a binary sidecar that later
+// reads of the unchanged file map instead (column-major tensor).
 void*  csv_read(const char* path, int skip_header);
 
-// Write a Tensor back to a CSV file.
+// csv_read keeping only the file columns listed in the columns tensor, in
+// that order; the cells of other columns are skipped without being parsed.
+void*  csv_read_cols(const char* path, int skip_header, void* columns);
+
+// Read a CSV file with a header as a typed table (Csv.cpp): column types
+// are inferred from the first rows, dates read as days since 1970-01-01 and
+// text columns are skipped (text_mode 0) or dictionary-coded (1).
+// table_data is the [rows x kept columns] tensor; columns are addressed by
+// their header name (table_index is -1 for an unknown or skipped name) and
+// table_label maps a code of a text column back to its text ("" if none).
+void*       csv_read_table(const char* path, int text_mode);
+void*       table_data(void* table);
+int         table_index(void* table, const char* name);
+void*       table_col(void* table, const char* name);
+const char* table_label(void* table, const char* name, int code);
+
+// Stream a CSV file of any size in batches (Csv.cpp). csv_open returns a
+// cursor; each csv_next_batch returns the next [<= n x cols] rows, and
+// [0 x cols] once the file is done. csv_close releases the file early.
+void*  csv_open(const char* path, int skip_header);
+void*  csv_open_cols(const char* path, int skip_header, void* columns);   // see csv_read_cols
+void*  csv_next_batch(void* cursor, int n);
+void   csv_close(void* cursor);
+
+// Write a Tensor back to a CSV file (Csv.cpp): each value as the shortest
+// text that reads back as the same float, or with digits significant digits
+// (1…9) when digits > 0.
 void   csv_write(const char* path, void* tensor_ptr);
+void   csv_write_digits(const char* path, void* tensor_ptr, int digits);
+
+// ── Binary tensor files (TensorFile.cpp) ──────
+// Write a tensor (any dtype and shape) to a binary tensor file.
+void   save_tensor(const char* path, void* tensor_ptr);
+
+// Map a file written by save_tensor: the tensor's elements are the mapping,
+// read on demand. nullptr when the file is missing or not a tensor file.
+void*  load_tensor(const char* path);
 
 // Get number of rows / cols in a CSV-loaded tensor
 int    csv_rows(void* tensor_ptr);
@@ -64,4 +382,58 @@ void*  csv_get_col(void* tensor_ptr, int col);
 // Get a sub-range of columns [col_start, col_end) as a new Tensor
 void*  csv_slice_cols(void* tensor_ptr, int col_start, int col_end);
 
+// ── Scaling (Scaler.cpp) ──────────────────────
+// Per-column scaling of the [rows x cols] matrix:
+//   normalize     min-max to [0, 1]
+//   standardize   zero mean, unit (population) standard deviation
+//   robust_scale  zero median, unit interquartile range
+void*  ml_normalize(void* tensor_ptr);
+void*  ml_standardize(void* tensor_ptr);
+void*  ml_robust_scale(void* tensor_ptr);
+void   ml_normalize_(void* tensor_ptr);
+void   ml_standardize_(void* tensor_ptr);
+void   ml_robust_scale_(void* tensor_ptr);
+void*  ml_normalize_reuse(void* tensor_ptr);
+void*  ml_standardize_reuse(void* tensor_ptr);
+void*  ml_robust_scale_reuse(void* tensor_ptr);
+
+// Fitted scalers (opaque handles): the statistics of X, applied to any
+// tensor with the same number of columns by ml_transform / ml_transform_.
+void*  ml_minmax_scaler(void* X);
+void*  ml_standard_scaler(void* X);
+void*  ml_robust_scaler(void* X);
+void*  ml_transform(void* scaler, void* tensor_ptr);
+void   ml_transform_(void* scaler, void* tensor_ptr);
+
+// ── ML ops ────────────────────────────────────
+void*  ml_shuffle(void* tensor_ptr);
+void*  ml_clip(void* tensor_ptr, float lo, float hi);
+
+// In place: overwrite the tensor's own elements (through a view, its parent's)
+void   ml_shuffle_(void* tensor_ptr);
+void   ml_scale_(void* tensor_ptr, float s);
+void   ml_clip_(void* tensor_ptr, float lo, float hi);
+
+// x = f(x) rewritten by the compiler: in place and returning x (retained)
+// when the caller holds the only reference and no view shares the buffer,
+// otherwise the same as the copying op.
+void*  ml_shuffle_reuse(void* tensor_ptr);
+void*  ml_clip_reuse(void* tensor_ptr, float lo, float hi);
+
+// First / last rows of a split at `ratio` (e.g. 0.8 → 80% / 20%)
+void*  ml_train_split(void* tensor_ptr, float ratio);
+void*  ml_test_split(void* tensor_ptr, float ratio);
+void*  ml_hstack(void* a, void* b);
+
+// Logistic regression (model handles are opaque)
+void*  lore_create(int max_iter, float lr);
+void   lore_fit(void* model, void* X, void* y);
+void*  lore_predict(void* model, void* X);
+void*  lore_predict_proba(void* model, void* X);
+void*  lore_weights(void* model);
+float  lore_bias(void* model);
+
+float  ml_accuracy(void* pred, void* labels);
+void*  ml_confusion(void* pred, void* labels);
+
 } // extern "C"
\ No newline at end of file
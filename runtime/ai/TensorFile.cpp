@@ -0,0 +1,181 @@
+#include "Tensor.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Binary tensor files (save_tensor / load_tensor).
+//
+//   offset 0    FileHeader (32 bytes, little-endian)
+//   offset 32   ndim int64 dimensions
+//   dataOffset  the elements, dense row-major in the tensor's dtype
+//
+// dataOffset is rounded up to 64 bytes, so mapped elements are as aligned
+// as pooled buffers. load_tensor maps the file and returns a tensor whose
+// elements are the mapping itself: nothing is read or decoded up front and
+// pages come in as they are touched. The mapping is private, so writes into
+// a loaded tensor (csv_set, in-place ops) copy the touched pages and never
+// reach the file. save_tensor writes the header and then the elements in a
+// few large write() calls straight from the tensor's buffer.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace {
+
+constexpr char     MAGIC[8]      = {'N', 'E', 'X', 'A', 'T', 'E', 'N', 'S'};
+constexpr uint32_t VERSION       = 1;
+constexpr uint32_t MAX_DIMS      = 32;
+constexpr size_t   DATA_ALIGN    = 64;
+constexpr size_t   WRITE_CHUNK   = (size_t)8 << 20;   // bytes per write() call
+
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    int32_t  dtype;          // DType
+    uint32_t ndim;
+    uint32_t dataOffset;     // bytes from the start of the file
+    float    quantScale;     // i8 only
+    int32_t  quantZero;
+};
+static_assert(sizeof(FileHeader) == 32, "tensor file header");
+
+bool writeAll(int fd, const void* p, size_t n) {
+    auto* b = static_cast<const uint8_t*>(p);
+    while (n > 0) {
+        ssize_t w = ::write(fd, b, std::min(n, WRITE_CHUNK));
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        b += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+bool writeTensor(int fd, const nexa::Tensor& t) {
+    uint32_t ndim = (uint32_t)t.ndim();
+    size_t   dims = sizeof(FileHeader) + ndim * sizeof(int64_t);
+    std::vector<uint8_t> head((dims + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN, 0);
+
+    FileHeader h;
+    std::memcpy(h.magic, MAGIC, sizeof MAGIC);
+    h.version    = VERSION;
+    h.dtype      = (int32_t)t.dtype;
+    h.ndim       = ndim;
+    h.dataOffset = (uint32_t)head.size();
+    h.quantScale = t.quant.scale;
+    h.quantZero  = t.quant.zeroPoint;
+    std::memcpy(head.data(), &h, sizeof h);
+    for (uint32_t d = 0; d < ndim; ++d) {
+        int64_t v = t.shape[d];
+        std::memcpy(head.data() + sizeof h + d * sizeof v, &v, sizeof v);
+    }
+    if (!writeAll(fd, head.data(), head.size())) return false;
+
+    size_t bytes = t.numel() * nexa::dtypeSize(t.dtype);
+    if (t.isContiguous()) return writeAll(fd, t.raw(), bytes);
+
+    // A strided f32 view is staged a block of rows at a time; other dtypes
+    // keep their encoding through a dense copy.
+    if (t.dtype != nexa::DType::F32) {
+        nexa::Tensor d = t.denseCopy();
+        return writeAll(fd, d.raw(), bytes);
+    }
+    int64_t cols = t.cols, block = std::max<int64_t>(1, (int64_t)(WRITE_CHUNK / sizeof(float)) / std::max<int64_t>(cols, 1));
+    std::vector<float> buf((size_t)(block * cols));
+    for (int64_t i = 0; i < t.rows; i += block) {
+        int64_t nb = std::min(block, t.rows - i), ld;
+        const float* rows = t.rowsData(i, nb, buf.data(), ld);
+        if (ld != cols) {
+            for (int64_t r = 0; r < nb; ++r) std::copy(rows + r * ld, rows + r * ld + cols, buf.data() + r * cols);
+            rows = buf.data();
+        }
+        if (!writeAll(fd, rows, (size_t)(nb * cols) * sizeof(float))) return false;
+    }
+    return true;
+}
+
+// The header of a mapped file; nullptr (and a message) when it is not a
+// tensor file this runtime can read.
+const FileHeader* checkHeader(const char* path, const uint8_t* base, size_t size, std::vector<int>& shape) {
+    auto bad = [&](const char* why) -> const FileHeader* {
+        fprintf(stderr, "[nexa] load_tensor: '%s' %s\n", path, why);
+        return nullptr;
+    };
+    if (size < sizeof(FileHeader)) return bad("is too short for a tensor file");
+    auto* h = reinterpret_cast<const FileHeader*>(base);
+    if (std::memcmp(h->magic, MAGIC, sizeof MAGIC) != 0) return bad("is not a tensor file");
+    if (h->version != VERSION) return bad("has an unsupported version");
+    if (h->dtype < 0 || h->dtype > (int32_t)nexa::DType::I8) return bad("has an unknown dtype");
+    if (h->ndim > MAX_DIMS || h->dataOffset % DATA_ALIGN != 0 ||
+        h->dataOffset < sizeof(FileHeader) + h->ndim * sizeof(int64_t) || h->dataOffset > size)
+        return bad("has a corrupt header");
+
+    size_t n = 1;
+    for (uint32_t d = 0; d < h->ndim; ++d) {
+        int64_t v;
+        std::memcpy(&v, base + sizeof(FileHeader) + d * sizeof v, sizeof v);
+        if (v < 0 || v > INT_MAX) return bad("has a corrupt shape");
+        shape.push_back((int)v);
+        n *= (size_t)v;
+    }
+    if (size - h->dataOffset < n * nexa::dtypeSize((nexa::DType)h->dtype)) return bad("is truncated");
+    return h;
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LLVM Bridge
+// ─────────────────────────────────────────────────────────────────────────────
+extern "C" {
+
+void save_tensor(const char* path, void* tp) {
+    auto* t = nexa::tensorArg(tp);
+    if (!t) return;
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "[nexa] save_tensor: cannot open '%s': %s\n", path, strerror(errno));
+        return;
+    }
+    bool ok = writeTensor(fd, *t);
+    if (::close(fd) != 0) ok = false;
+    if (!ok) fprintf(stderr, "[nexa] save_tensor: write to '%s' failed: %s\n", path, strerror(errno));
+}
+
+void* load_tensor(const char* path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[nexa] load_tensor: cannot open '%s': %s\n", path, strerror(errno));
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        fprintf(stderr, "[nexa] load_tensor: '%s' is empty\n", path);
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = (size_t)st.st_size;
+    void*  map  = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);                                  // the mapping keeps the file open
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[nexa] load_tensor: cannot map '%s': %s\n", path, strerror(errno));
+        return nullptr;
+    }
+    auto* base = static_cast<uint8_t*>(map);
+    std::shared_ptr<uint8_t> file(base, [size](uint8_t* p) { munmap(p, size); });
+
+    std::vector<int> shape;
+    const FileHeader* h = checkHeader(path, base, size, shape);
+    if (!h) return nullptr;
+    // The elements are the tensor's storage; the whole mapping lives as long as they do.
+    std::shared_ptr<uint8_t> data(file, base + h->dataOffset);
+    return new nexa::Tensor((nexa::DType)h->dtype, std::move(data), shape, {h->quantScale, h->quantZero});
+}
+
+} // extern "C"
@@ -1,4 +1,5 @@
 #include "FileRuntime.h"
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -73,4 +74,11 @@ int nexa_file_exists(const char* path) {
     return 1;
 }
 
+// ── nexa_file_remove(path) → void ────────────────────────────────────────────
+// Deletes the file at `path`; a missing file is not an error.
+void nexa_file_remove(const char* path) {
+    if (remove(path) != 0 && errno != ENOENT)
+        fprintf(stderr, "[nexa runtime] error: cannot remove '%s': %s\n", path, strerror(errno));
+}
+
 } // extern "C"
\ No newline at end of file
@@ -16,6 +16,9 @@ void nexa_file_append(const char* path, const char* content);
 // Returns 1 if file exists, 0 otherwise
 int nexa_file_exists(const char* path);
 
+// Delete file (no error if it does not exist)
+void nexa_file_remove(const char* path);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file